@@ -7,12 +7,16 @@
 #include "baresip/command.h"
 
 #include "json/parser.h"
+#include "json/serializer.h"
 #include "netstring/reader.h"
+#include "netstring/writer.h"
 #include "io/stream-buffer.h"
 #include "io/event-buffer.h"
 #include "baresip-proto-parser.h"
+#include "fmt.h"
 
 #include <sstream>
+#include <unordered_map>
 
 namespace Baresip {
 
@@ -20,12 +24,19 @@ class CtrlImpl : public Ctrl {
 public:
 	explicit CtrlImpl(IO::ReadEventBuffer &, IO::WriteBuffer &);
 
+	std::string send(Command::Request const&, ResponseCallback const&) final;
+	size_t pending() const final;
+	void reset() final;
+
 private:
+	std::string make_token();
 	void on_json(Json::Object const&);
 
 	IO::StreamBuffer recvbuf_;
 	Netstring::Reader netstring_;
 	IO::WriteBuffer & sendbuf_;
+	std::unordered_map<std::string, ResponseCallback> pending_;
+	uint64_t next_token_ = 0;
 };
 
 std::unique_ptr<Ctrl> Ctrl::create(IO::ReadEventBuffer & recvbuf, IO::WriteBuffer & sendbuf)
@@ -48,6 +59,53 @@ CtrlImpl::CtrlImpl(IO::ReadEventBuffer & recvbuf, IO::WriteBuffer & sendbuf)
 	});
 }
 
+std::string CtrlImpl::send(Command::Request const& req, ResponseCallback const& cb)
+{
+	auto token = req.token.empty() ? make_token() : req.token;
+	if (!pending_.emplace(token, cb).second) {
+		throw std::runtime_error(FMT_FORMAT("command token '%s' already in use", token));
+	}
+
+	auto obj = Json::make_object({
+		{"command", req.command},
+		{"token", token},
+	});
+	if (!req.params.empty()) {
+		obj.emplace("params", Json::Value{req.params});
+	}
+	Netstring::write(sendbuf_, Json::to_string(obj));
+
+	return token;
+}
+
+std::string CtrlImpl::make_token()
+{
+	// prefixed to stay clear of tokens chosen by callers, skipping any
+	// a caller picked from this range anyway
+	auto token = std::string{};
+	do {
+		token = "cl-" + std::to_string(++next_token_);
+	} while (pending_.find(token) != pending_.end());
+	return token;
+}
+
+size_t CtrlImpl::pending() const
+{
+	return pending_.size();
+}
+
+void CtrlImpl::reset()
+{
+	netstring_.reset();
+
+	auto pending = std::exchange(pending_, {});
+	for (auto const& cmd : pending) {
+		if (cmd.second) {
+			cmd.second(Command::Response{false, "connection lost", cmd.first});
+		}
+	}
+}
+
 void CtrlImpl::on_json(Json::Object const& obj)
 {
 	auto [is_event, ev] = Event::parse(obj);
@@ -56,9 +114,18 @@ void CtrlImpl::on_json(Json::Object const& obj)
 	}
 
 	auto [is_resp, resp] = Command::parse(obj);
-	if (is_resp) {
-		on_response_(resp);
+	if (!is_resp) {
+		return;
+	}
+
+	if (auto it = pending_.find(resp.token); it != pending_.end()) {
+		auto cb = std::move(it->second);
+		pending_.erase(it);
+		if (cb) {
+			cb(resp);
+		}
 	}
+	on_response_(resp);
 }
 
 }
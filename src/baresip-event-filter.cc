@@ -0,0 +1,101 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "baresip/event-filter.h"
+#include "fmt.h"
+
+#include <unordered_map>
+
+namespace Baresip {
+
+class EventFilterImpl : public EventFilter {
+public:
+	EventFilterImpl()
+	{
+		on_event_.reset([this] (auto const& ev) {
+			if (pass(ev)) {
+				on_forward_(ev);
+			}
+		});
+	}
+
+	bool pass(Event::Any const&) final;
+	Stats stats() const final;
+	void reset() final;
+
+private:
+	bool repeated(Event::Register const&);
+	bool repeated(Event::Call const&);
+
+	// last event type by account and by open call
+	std::unordered_map<InternedString, Event::Register::Type> registrations_;
+	std::unordered_map<std::string, Event::Call::Type> calls_;
+	Stats stats_;
+};
+
+std::unique_ptr<EventFilter> EventFilter::create()
+{
+	return std::make_unique<EventFilterImpl>();
+}
+
+bool EventFilterImpl::repeated(Event::Register const& ev)
+{
+	auto [it, inserted] = registrations_.try_emplace(ev.accountaor, ev.type);
+	if (inserted || it->second != ev.type) {
+		it->second = ev.type;
+		return false;
+	}
+	return true;
+}
+
+bool EventFilterImpl::repeated(Event::Call const& ev)
+{
+	auto it = calls_.find(ev.id);
+	if (ev.type == Event::Call::Type::Closed) {
+		// closed ids may be reused for new calls
+		if (it != calls_.end()) {
+			calls_.erase(it);
+		}
+		return false;
+	}
+
+	if (it == calls_.end()) {
+		calls_.emplace(ev.id, ev.type);
+		return false;
+	}
+	if (it->second != ev.type) {
+		it->second = ev.type;
+		return false;
+	}
+	return true;
+}
+
+bool EventFilterImpl::pass(Event::Any const& ev)
+{
+	if (std::visit([this] (auto const& e) { return repeated(e); }, ev)) {
+		++stats_.suppressed;
+		return false;
+	}
+	++stats_.forwarded;
+	return true;
+}
+
+EventFilter::Stats EventFilterImpl::stats() const
+{
+	return stats_;
+}
+
+void EventFilterImpl::reset()
+{
+	registrations_.clear();
+	calls_.clear();
+}
+
+std::string to_string(EventFilter::Stats const& stats)
+{
+	return FMT_FORMAT("forwarded=%s suppressed=%s", stats.forwarded, stats.suppressed);
+}
+
+}
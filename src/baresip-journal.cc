@@ -0,0 +1,214 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "baresip/journal.h"
+#include "posix/fd.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Baresip {
+namespace Journal {
+
+namespace {
+
+void put_varint(std::string & buf, uint64_t value)
+{
+	while (value >= 0x80) {
+		buf.push_back(char(value | 0x80));
+		value >>= 7;
+	}
+	buf.push_back(char(value));
+}
+
+void put_string(std::string & buf, std::string_view const& str)
+{
+	put_varint(buf, str.size());
+	buf.append(str);
+}
+
+template <typename Enum>
+void put_enum(std::string & buf, Enum value)
+{
+	buf.push_back(char(value));
+}
+
+void put_event(std::string & buf, Event::Register const& ev)
+{
+	put_enum(buf, ev.type);
+	put_string(buf, ev.accountaor.view());
+	put_string(buf, ev.param);
+}
+
+void put_event(std::string & buf, Event::Call const& ev)
+{
+	put_enum(buf, ev.type);
+	put_string(buf, ev.accountaor.view());
+	put_enum(buf, ev.direction);
+	put_string(buf, ev.peeruri);
+	put_string(buf, ev.id);
+	put_string(buf, ev.param);
+}
+
+class Decoder {
+public:
+	explicit Decoder(std::string_view const& data)
+	:
+		data_(data)
+	{ }
+
+	uint64_t varint()
+	{
+		uint64_t res{0};
+		for (unsigned shift{0}; shift < 64; shift += 7) {
+			auto byte = uint8_t(take(1)[0]);
+			// the tenth byte only has room for bit 63
+			if (shift == 63 && (byte & 0x7e)) {
+				break;
+			}
+			res |= uint64_t(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				return res;
+			}
+		}
+		throw std::runtime_error("journal: varint overflow");
+	}
+
+	std::string_view string()
+	{
+		return take(varint());
+	}
+
+	template <typename Enum>
+	Enum enumeration(Enum last)
+	{
+		auto value = uint8_t(take(1)[0]);
+		if (value > uint8_t(last)) {
+			throw std::runtime_error("journal: invalid enum value");
+		}
+		return Enum(value);
+	}
+
+	std::string_view take(uint64_t size)
+	{
+		if (size > data_.size()) {
+			throw std::runtime_error("journal: truncated record");
+		}
+		auto res = data_.substr(0, size);
+		data_.remove_prefix(size);
+		return res;
+	}
+
+	bool empty() const
+	{
+		return data_.empty();
+	}
+
+	std::string_view rest() const
+	{
+		return data_;
+	}
+
+private:
+	std::string_view data_;
+};
+
+Event::Register get_register(Decoder & dec)
+{
+	Event::Register ev;
+	ev.type = dec.enumeration(Event::Register::Type::Unregistering);
+	ev.accountaor = dec.string();
+	ev.param = dec.string();
+	return ev;
+}
+
+Event::Call get_call(Decoder & dec)
+{
+	Event::Call ev;
+	ev.type = dec.enumeration(Event::Call::Type::Closed);
+	ev.accountaor = dec.string();
+	ev.direction = dec.enumeration(Event::Call::Direction::Outgoing);
+	ev.peeruri = dec.string();
+	ev.id = dec.string();
+	ev.param = dec.string();
+	return ev;
+}
+
+}
+
+Writer::Writer(std::shared_ptr<Posix::Fd> const& fd)
+:
+	fd_(fd)
+{
+	buf_ = Magic;
+	fd_->write(buf_.data(), buf_.size());
+}
+
+void Writer::write(Event::Any const& ev)
+{
+	write(Record{std::chrono::steady_clock::now().time_since_epoch(), ev});
+}
+
+void Writer::write(Record const& record)
+{
+	auto delta = record.time > last_ ? record.time - last_ : std::chrono::nanoseconds{0};
+	last_ = std::max(last_, record.time);
+
+	// payload first, its size is only known afterwards
+	payload_.clear();
+	put_varint(payload_, delta.count());
+	put_varint(payload_, record.event.index());
+	std::visit([this] (auto const& ev) { put_event(payload_, ev); }, record.event);
+
+	buf_.clear();
+	put_varint(buf_, payload_.size());
+	buf_.append(payload_);
+
+	for (size_t pos{0}; pos < buf_.size();) {
+		pos += fd_->write(buf_.data() + pos, buf_.size() - pos);
+	}
+}
+
+Reader::Reader(std::string_view const& data)
+:
+	data_(data)
+{
+	if (data_.substr(0, Magic.size()) != Magic) {
+		throw std::runtime_error("journal: bad magic");
+	}
+	data_.remove_prefix(Magic.size());
+}
+
+bool Reader::next(Record & record)
+{
+	if (data_.empty()) {
+		return false;
+	}
+
+	Decoder dec{data_};
+	auto payload = Decoder{dec.take(dec.varint())};
+	data_ = dec.rest();
+
+	last_ += std::chrono::nanoseconds(payload.varint());
+	record.time = last_;
+
+	switch (payload.varint()) {
+	case 0:
+		record.event = get_register(payload);
+		break;
+	case 1:
+		record.event = get_call(payload);
+		break;
+	default:
+		throw std::runtime_error("journal: unknown event");
+	}
+
+	if (!payload.empty()) {
+		throw std::runtime_error("journal: trailing data in record");
+	}
+	return true;
+}
+
+}}
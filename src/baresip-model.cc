@@ -5,6 +5,11 @@
 */
 #include "baresip/model.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <unordered_map>
+
 namespace Baresip {
 
 namespace {
@@ -21,6 +26,17 @@ Call::State call_state(Event::Call::Type type)
 	return Call::State::Closed;
 }
 
+Model::Registration registration_state(Event::Register::Type type)
+{
+	switch (type) {
+	case Event::Register::Type::Fail: return Model::Registration::Fail;
+	case Event::Register::Type::Ok: return Model::Registration::Ok;
+	case Event::Register::Type::Unregistering: return Model::Registration::Unknown;
+	}
+
+	return Model::Registration::Unknown;
+}
+
 Call::Direction call_direction(Event::Call::Direction direction)
 {
 	switch (direction) {
@@ -44,31 +60,27 @@ public:
 		peeruri_(ev.peeruri)
 	{ }
 
-	bool on_event(Event::Call const& ev)
+	void on_event(Event::Call const& ev)
 	{
-		if (Id{ev.id} != id_) {
-			return false;
-		}
-
 		auto state = call_state(ev.type);
 		if (state_ != state) {
 			state_ = state;
 			on_state_change_(state_);
 		}
-		return true;
 	}
 
 	Id id() const final;
 	State state() const final;
 	Direction direction() const final;
-	std::string accountaor() const final;
-	std::string peeruri() const final;
+	std::string_view accountaor() const final;
+	std::string_view peeruri() const final;
 
 private:
 	Id id_;
-	State state_;
+	// read by other threads through a CallList
+	std::atomic<State> state_;
 	Direction direction_;
-	std::string accountaor_;
+	InternedString accountaor_;
 	std::string peeruri_;
 };
 
@@ -78,14 +90,26 @@ public:
 	:
 		event_handler_(*this)
 	{
-		on_event_.reset([this] (auto const& ev) { std::visit(event_handler_, ev); });
+		on_event_.reset([this] (auto const& ev) { handle(ev); });
+	}
+
+	void handle(Event::Any const& ev) final
+	{
+		std::visit(event_handler_, ev);
 	}
 
 	Registration registration() const final;
-	std::vector<std::shared_ptr<Call>> calls() const final;
+	Registration registration(InternedString const&) const final;
+	std::vector<Account> accounts() const final;
+	CallList calls() const final;
+	CallList history() const final;
 
 private:
+	using Calls = CallList::Calls;
+
 	void on_call_event(Event::Call const&);
+	void close(std::shared_ptr<CallImpl> const&);
+	static void publish(std::shared_ptr<Calls const> &, Calls &&);
 	void on_register_event(Event::Register const&);
 
 	friend class EventHandler;
@@ -112,10 +136,20 @@ private:
 	};
 
 	EventHandler event_handler_;
-	std::vector<std::shared_ptr<CallImpl>> calls_;
-	Registration registration_ = Registration::Unknown;
+	// open calls by id, calls_ holds them in order of creation
+	std::unordered_map<Call::Id, std::shared_ptr<CallImpl>> index_;
+	std::shared_ptr<Calls const> calls_ = std::make_shared<Calls const>();
+	std::shared_ptr<Calls const> history_ = std::make_shared<Calls const>();
+	std::unordered_map<InternedString, Account> accounts_;
+	// number of accounts per Registration state
+	std::array<size_t, 3> registrations_ = {};
 };
 
+CallList::CallList()
+:
+	calls_(std::make_shared<Calls const>())
+{ }
+
 std::unique_ptr<Model> Model::create()
 {
 	return std::make_unique<ModelImpl>();
@@ -136,52 +170,127 @@ Call::Direction CallImpl::direction() const
 	return direction_;
 }
 
-std::string CallImpl::accountaor() const
+std::string_view CallImpl::accountaor() const
 {
-	return accountaor_;
+	return accountaor_.view();
 }
 
-std::string CallImpl::peeruri() const
+std::string_view CallImpl::peeruri() const
 {
 	return peeruri_;
 }
 
 void ModelImpl::on_call_event(Event::Call const& ev)
 {
-	auto new_call = std::none_of(begin(calls_), end(calls_),
-		[&ev](auto const& call) { return call->on_event(ev); });
+	auto id = Call::Id{ev.id};
+	auto it = index_.find(id);
+	if (it == index_.end()) {
+		auto call = std::make_shared<CallImpl>(ev);
+		auto calls = *calls_;
+		calls.push_back(call);
+		publish(calls_, std::move(calls));
+		index_.emplace(id, call);
+		on_call_(call);
+		if (call->state() == Call::State::Closed) {
+			close(call);
+		}
+		return;
+	}
+
+	// copy, close() drops the table entries
+	auto call = it->second;
+	call->on_event(ev);
+	if (call->state() == Call::State::Closed) {
+		close(call);
+	}
+}
+
+void ModelImpl::close(std::shared_ptr<CallImpl> const& call)
+{
+	index_.erase(call->id());
+
+	auto calls = *calls_;
+	calls.erase(std::find(begin(calls), end(calls), call));
+	publish(calls_, std::move(calls));
 
-	if (new_call) {
-		calls_.push_back(std::make_shared<CallImpl>(ev));
-		on_call_(calls_.back());
+	auto history = *history_;
+	if (history.size() == HistorySize) {
+		history.erase(begin(history));
 	}
+	history.push_back(call);
+	publish(history_, std::move(history));
+}
+
+void ModelImpl::publish(std::shared_ptr<Calls const> & list, Calls && calls)
+{
+	std::atomic_store(&list, std::shared_ptr<Calls const>(std::make_shared<Calls>(std::move(calls))));
 }
 
 void ModelImpl::on_register_event(Event::Register const& ev)
 {
-	switch (ev.type) {
-	case Event::Register::Type::Fail:
-		registration_ = Registration::Fail;
-		break;
-	case Event::Register::Type::Ok:
-		registration_ = Registration::Ok;
-		break;
-	case Event::Register::Type::Unregistering:
-		registration_ = Registration::Unknown;
-		break;
+	auto state = registration_state(ev.type);
+
+	auto [it, inserted] = accounts_.try_emplace(ev.accountaor, Account{ev.accountaor, Registration::Unknown, {}, 0});
+	auto & account = it->second;
+	if (inserted) {
+		++registrations_[size_t(account.registration)];
+	}
+	// a new account starts out as Unknown
+	if (account.registration == state) {
+		return;
 	}
+
+	--registrations_[size_t(account.registration)];
+	++registrations_[size_t(state)];
+
+	if (account.registration == Registration::Ok && state == Registration::Fail) {
+		++account.flaps;
+	}
+	account.registration = state;
+	account.since = std::chrono::steady_clock::now();
+
+	on_registration_(account);
 }
 
 Model::Registration ModelImpl::registration() const
 {
-	return registration_;
+	if (registrations_[size_t(Registration::Fail)] != 0) {
+		return Registration::Fail;
+	}
+	if (!accounts_.empty() && registrations_[size_t(Registration::Ok)] == accounts_.size()) {
+		return Registration::Ok;
+	}
+	return Registration::Unknown;
+}
+
+Model::Registration ModelImpl::registration(InternedString const& aor) const
+{
+	auto it = accounts_.find(aor);
+	return it != accounts_.end() ? it->second.registration : Registration::Unknown;
 }
 
-std::vector<std::shared_ptr<Call>> ModelImpl::calls() const
+std::vector<Model::Account> ModelImpl::accounts() const
 {
-	std::vector<std::shared_ptr<Call>> res(calls_.size());
-	std::copy(begin(calls_), end(calls_), begin(res));
+	std::vector<Account> res;
+	res.reserve(accounts_.size());
+	for (auto const& account: accounts_) {
+		res.push_back(account.second);
+	}
+
+	std::sort(begin(res), end(res), [](auto const& l, auto const& r) {
+		return l.aor < r.aor;
+	});
 	return res;
 }
 
+CallList ModelImpl::calls() const
+{
+	return CallList{std::atomic_load(&calls_)};
+}
+
+CallList ModelImpl::history() const
+{
+	return CallList{std::atomic_load(&history_)};
+}
+
 }
@@ -0,0 +1,204 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "baresip-stub.h"
+
+#include "io/buffer.h"
+#include "io/stream-buffer.h"
+#include "json/parser.h"
+#include "json/serializer.h"
+#include "netstring/reader.h"
+#include "netstring/writer.h"
+#include "posix/socket.h"
+#include "posix/socket-address.h"
+
+#include <sys/socket.h>
+
+#include <functional>
+#include <sstream>
+#include <system_error>
+
+class BaresipStub::Client {
+public:
+	Client(EPoll::Ctrl & poller, std::shared_ptr<Posix::Socket> const& socket)
+	:
+		socket_(socket),
+		poller_(poller)
+	{ }
+
+	// returns false if the connection was closed by the peer
+	bool read(std::function<void(Json::Object const&)> const& on_message)
+	{
+		recvbuf_.reserve(4096);
+		size_t size{0};
+		try {
+			size = socket_->read(recvbuf_.wstart(), recvbuf_.wsize());
+		} catch (std::system_error const& e) {
+			return e.code() == std::errc::resource_unavailable_try_again;
+		}
+		if (size == 0) {
+			return false;
+		}
+		recvbuf_.fill(size);
+
+		auto data = std::string{};
+		while (reader_.parse(data)) {
+			std::stringstream ss{data};
+			on_message(Json::parse_object(ss));
+		}
+		return true;
+	}
+
+	void send(Json::Object const& obj)
+	{
+		Netstring::write(sendbuf_, Json::to_string(obj));
+		flush();
+	}
+
+	// returns false if the connection failed
+	bool flush()
+	{
+		if (!sendbuf_.empty()) {
+			try {
+				sendbuf_.drain(socket_->write(sendbuf_.rstart(), sendbuf_.rsize()));
+			} catch (std::system_error const& e) {
+				if (e.code() != std::errc::resource_unavailable_try_again) {
+					return false;
+				}
+			}
+		}
+
+		auto ev = EPoll::Events{EPoll::Event::In};
+		if (!sendbuf_.empty()) {
+			ev |= EPoll::Event::Out;
+		}
+		if (ev != ev_) {
+			ev_ = ev;
+			poller_.mod(socket_, ev_);
+		}
+		return true;
+	}
+
+	std::shared_ptr<Posix::Socket> socket() const
+	{
+		return socket_;
+	}
+
+private:
+	std::shared_ptr<Posix::Socket> socket_;
+	IO::Buffer recvbuf_;
+	IO::StreamBuffer stream_{recvbuf_};
+	Netstring::Reader reader_{stream_};
+	IO::Buffer sendbuf_;
+	EPoll::Events ev_{EPoll::Event::In};
+	EPoll::Ctrl & poller_;
+};
+
+BaresipStub::BaresipStub(
+	EPoll::Ctrl & poller,
+	Posix::SocketFactory & socket_factory,
+	Posix::SocketAddress const& addr)
+:
+	poller_(poller)
+{
+	auto domain = Posix::SocketFactory::Params::Domain::Unix;
+	switch (addr.family()) {
+	case AF_INET:
+		domain = Posix::SocketFactory::Params::Domain::Inet;
+		break;
+	case AF_INET6:
+		domain = Posix::SocketFactory::Params::Domain::Inet6;
+		break;
+	}
+
+	socket_ = socket_factory.make_socket({
+		domain,
+		Posix::SocketFactory::Params::Type::Stream,
+		Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec});
+	socket_->bind(addr);
+	socket_->listen(8);
+
+	poller_.add(socket_, EPoll::Events{EPoll::Event::In}, [this] (auto const&) { on_accept(); });
+}
+
+BaresipStub::~BaresipStub()
+{
+	disconnect();
+	poller_.del(socket_);
+}
+
+void BaresipStub::send(Json::Object const& obj)
+{
+	for (auto const& client : clients_) {
+		client.second->send(obj);
+	}
+}
+
+void BaresipStub::disconnect()
+{
+	while (!clients_.empty()) {
+		close(clients_.begin()->first);
+	}
+}
+
+size_t BaresipStub::clients() const
+{
+	return clients_.size();
+}
+
+void BaresipStub::on_accept()
+{
+	std::shared_ptr<Posix::Socket> socket;
+	try {
+		socket = socket_->accept(Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec);
+	} catch (std::system_error const& e) {
+		if (e.code() == std::errc::resource_unavailable_try_again) {
+			return;
+		}
+		throw;
+	}
+
+	auto fd = socket->get();
+	auto client = std::make_unique<Client>(poller_, socket);
+	poller_.add(socket, EPoll::Events{EPoll::Event::In}, [this, fd] (auto const& ev) {
+		auto & client = *clients_.at(fd);
+		auto open = true;
+		if (ev & EPoll::Event::In) {
+			open = client.read([this, &client] (auto const& obj) { on_message(client, obj); });
+		}
+		if (open && ev & EPoll::Event::Out) {
+			open = client.flush();
+		}
+		if (!open || ev & EPoll::Event::Err || ev & EPoll::Event::Hup) {
+			close(fd);
+		}
+	});
+	clients_.emplace(fd, std::move(client));
+}
+
+void BaresipStub::on_message(Client & client, Json::Object const& obj)
+{
+	auto res = Json::make_object({
+		{"response", true},
+		{"ok", true},
+		{"data", ""},
+	});
+	if (auto token = obj.find("token"); token != obj.end()) {
+		res.emplace("token", token->second);
+	}
+
+	on_command_(obj);
+	client.send(res);
+}
+
+void BaresipStub::close(int fd)
+{
+	auto it = clients_.find(fd);
+	if (it == clients_.end()) {
+		return;
+	}
+	poller_.del(it->second->socket());
+	clients_.erase(it);
+}
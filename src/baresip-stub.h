@@ -0,0 +1,57 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "epoll/ctrl.h"
+#include "json/types.h"
+#include "signals.h"
+
+namespace Posix {
+class Socket;
+class SocketAddress;
+class SocketFactory;
+}
+
+// Local stand-in for the baresip ctrl_tcp module.
+//
+// Listens on the given address, answers every netstring encoded
+// command with an ok response carrying the token of the command and
+// sends events to all connected clients. Use it in tests and
+// benchmarks to run the control path without a SIP stack.
+class BaresipStub {
+public:
+	BaresipStub(EPoll::Ctrl &, Posix::SocketFactory &, Posix::SocketAddress const&);
+
+	BaresipStub(BaresipStub const&) = delete;
+	BaresipStub & operator=(BaresipStub const&) = delete;
+
+	~BaresipStub();
+
+	SignalProxy<void(Json::Object const&)> & on_command{on_command_};
+
+	// send a message, usually an event, to all clients
+	void send(Json::Object const&);
+
+	// drop all client connections
+	void disconnect();
+
+	size_t clients() const;
+
+private:
+	class Client;
+
+	void on_accept();
+	void on_message(Client &, Json::Object const&);
+	void close(int);
+
+	std::shared_ptr<Posix::Socket> socket_;
+	std::map<int, std::unique_ptr<Client>> clients_;
+	EPoll::Ctrl & poller_;
+	Signal<void(Json::Object const&)> on_command_;
+};
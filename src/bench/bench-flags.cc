@@ -0,0 +1,43 @@
+#include "ubench/macros.h"
+#include "epoll/ctrl.h"
+#include "flags.h"
+
+#include <array>
+
+namespace benchmarks {
+namespace flags {
+
+UBENCH_CASE(dispatch_bench)
+{
+	auto events = std::array<EPoll::Events, 3>{
+		EPoll::Events{EPoll::Event::In},
+		EPoll::Event::In|EPoll::Event::Out,
+		EPoll::Event::Err|EPoll::Event::Hup,
+	};
+	int sum{0};
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		dispatch(events[i % events.size()],
+			on_flag(EPoll::Event::In, [&sum] () { sum += 1; }),
+			on_flag(EPoll::Event::Out, [&sum] () { sum += 2; }),
+			on_flag(EPoll::Event::Err, [&sum] () { sum += 3; }),
+			on_flag(EPoll::Event::Hup, [&sum] () { sum += 4; }));
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(iterate_bench)
+{
+	auto events = EPoll::Event::In|EPoll::Event::Out|EPoll::Event::Hup;
+	int sum{0};
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		for (auto ev : events) {
+			sum += int(ev);
+		}
+		UBench::do_not_optimize(events);
+	}
+	UBench::do_not_optimize(sum);
+}
+
+}}
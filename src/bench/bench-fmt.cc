@@ -0,0 +1,33 @@
+#include "ubench/macros.h"
+#include "fmt.h"
+
+namespace benchmarks {
+namespace fmt {
+
+UBENCH_CASE(format_bench)
+{
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto str = Fmt::format("::epoll_ctl(%s, EPOLL_CTL_ADD, %s, &epoll_ev): %s", 3, i, "failed");
+		UBench::do_not_optimize(str);
+	}
+}
+
+UBENCH_CASE(format_hex_bench)
+{
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto str = Fmt::format("flags %x", i);
+		UBench::do_not_optimize(str);
+	}
+}
+
+UBENCH_CASE(format_to_bench)
+{
+	char buf[128];
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto len = Fmt::format_to(buf, sizeof(buf), "::epoll_ctl(%s, EPOLL_CTL_ADD, %s, &epoll_ev): %s", 3, i, "failed");
+		UBench::do_not_optimize(len);
+		UBench::do_not_optimize(buf);
+	}
+}
+
+}}
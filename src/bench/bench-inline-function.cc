@@ -0,0 +1,51 @@
+#include "ubench/macros.h"
+#include "inline-function.h"
+
+#include <functional>
+
+namespace benchmarks {
+namespace inline_function {
+
+UBENCH_CASE(std_function_call_bench)
+{
+	int sum{0};
+	std::function<void(int)> fn{[&sum](int n) { sum += n; }};
+	UBench::do_not_optimize(fn);
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		fn(1);
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(inline_function_call_bench)
+{
+	int sum{0};
+	InlineFunction<void(int)> fn{[&sum](int n) { sum += n; }};
+	UBench::do_not_optimize(fn);
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		fn(1);
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(std_function_construct_bench)
+{
+	char pad[32] = {};
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		std::function<void()> fn{[pad] () { UBench::do_not_optimize(pad); }};
+		UBench::do_not_optimize(fn);
+	}
+}
+
+UBENCH_CASE(inline_function_construct_bench)
+{
+	char pad[32] = {};
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		InlineFunction<void()> fn{[pad] () { UBench::do_not_optimize(pad); }};
+		UBench::do_not_optimize(fn);
+	}
+}
+
+}}
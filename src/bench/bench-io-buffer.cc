@@ -0,0 +1,78 @@
+#include "ubench/macros.h"
+#include "io/buffer.h"
+#include "io/stream-buffer.h"
+
+#include <cstring>
+
+namespace benchmarks {
+namespace io_buffer {
+
+UBENCH_CASE(fill_drain_bench)
+{
+	auto buf = IO::Buffer{4096};
+	auto chunk = std::string(256, 'x');
+	state.set_bytes(chunk.size());
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		buf.reserve(chunk.size());
+		std::memcpy(buf.wstart(), chunk.data(), chunk.size());
+		buf.fill(chunk.size());
+		UBench::do_not_optimize(buf.rstart());
+		buf.drain(chunk.size());
+	}
+}
+
+// partial drains force reserve() to reclaim the space in front
+UBENCH_CASE(reserve_reclaim_bench)
+{
+	auto buf = IO::Buffer{4096};
+	state.set_bytes(1000);
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		buf.reserve(1000);
+		buf.fill(1000);
+		buf.drain(buf.rsize() > 3000 ? 2000 : 900);
+		UBench::do_not_optimize(buf.rstart());
+	}
+}
+
+UBENCH_CASE(stream_get_bench)
+{
+	auto data = std::string(4096, 'x');
+	auto buf = IO::Buffer{data.size()};
+	auto stream = IO::StreamBuffer{buf};
+	state.set_bytes(data.size());
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		buf.reserve(data.size());
+		std::memcpy(buf.wstart(), data.data(), data.size());
+		buf.fill(data.size());
+
+		int sum{0};
+		for (int c; (c = stream.get()) != IO::StreamBuffer::End;) {
+			sum += c;
+		}
+		UBench::do_not_optimize(sum);
+	}
+}
+
+UBENCH_CASE(stream_peek_bench)
+{
+	auto data = std::string(4096, 'x');
+	auto buf = IO::Buffer{data.size()};
+	auto stream = IO::StreamBuffer{buf};
+	buf.reserve(data.size());
+	std::memcpy(buf.wstart(), data.data(), data.size());
+	buf.fill(data.size());
+	state.set_bytes(data.size());
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		int sum{0};
+		for (size_t n{0}; n < data.size(); ++n) {
+			sum += stream.peek(n);
+		}
+		UBench::do_not_optimize(sum);
+	}
+}
+
+}}
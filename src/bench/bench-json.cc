@@ -0,0 +1,38 @@
+#include "ubench/macros.h"
+#include "json/parser.h"
+#include "json/serializer.h"
+
+#include <sstream>
+
+namespace benchmarks {
+namespace json {
+
+std::string const document = R"({"event":true,"class":"call","type":"CALL_RINGING",)"
+	R"("accountaor":"sip:9999-1@asterisk.example.com","direction":"outgoing",)"
+	R"("peeruri":"sip:7777@asterisk.example.com","id":"6d42101ce49915a3",)"
+	R"("param":"sip:7777@asterisk.example.com;transport=udp","numbers":[1,-2,300000,4]})";
+
+UBENCH_CASE(parse_bench)
+{
+	state.set_bytes(document.size());
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		std::stringstream ss{document};
+		auto obj = Json::parse_object(ss);
+		UBench::do_not_optimize(obj);
+	}
+}
+
+UBENCH_CASE(serialize_bench)
+{
+	std::stringstream ss{document};
+	auto obj = Json::parse_object(ss);
+	state.set_bytes(document.size());
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto str = Json::to_string(obj);
+		UBench::do_not_optimize(str);
+	}
+}
+
+}}
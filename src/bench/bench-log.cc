@@ -0,0 +1,64 @@
+#include "ubench/macros.h"
+#include "log/async-logger.h"
+
+#include <string>
+
+namespace benchmarks {
+namespace log {
+
+// the cost of post() on the calling thread with a sink doing some work
+class Fixture {
+public:
+	Fixture()
+	{
+		logger.on_message([this] (Log::Message const& msg) {
+			out += msg.get_msg();
+			out.clear();
+		});
+	}
+
+	Log::Logger logger;
+	std::string out;
+};
+
+UBENCH_CASE_WITH_FIXTURE(sync_post_bench, Fixture)
+{
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		logger.post(Log::Message{"button pressed"});
+	}
+}
+
+UBENCH_CASE_WITH_FIXTURE(async_post_bench, Fixture)
+{
+	// don't count starting and joining the writer thread
+	state.stop_timer();
+	auto async = Log::AsyncLogger::create(logger, {4096, Log::AsyncLogger::Policy::Block});
+	state.start_timer();
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		async->post(Log::Message{"button pressed"});
+	}
+
+	state.stop_timer();
+	async.reset();
+	state.start_timer();
+}
+
+// creating the message is all a sink which drops it pays for
+UBENCH_CASE(make_message_bench)
+{
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto msg = Log::make_message("call %s from %s state %s", i, "sip:7777@asterisk.example.com", 3);
+		UBench::do_not_optimize(msg);
+	}
+}
+
+UBENCH_CASE(deferred_message_bench)
+{
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto msg = Log::Message::deferred(Log::Level::Debug, "call %s from %s state %s", i, "sip:7777@asterisk.example.com", 3);
+		UBench::do_not_optimize(msg);
+	}
+}
+
+}}
@@ -0,0 +1,48 @@
+#include "ubench/macros.h"
+#include "netlink/uevent.h"
+
+#include <string>
+
+namespace benchmarks {
+namespace netlink_uevent {
+
+using namespace std::string_literals;
+
+auto const KernelBind =
+	"bind@/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0\0"
+	"ACTION=bind\0"
+	"DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0\0"
+	"SUBSYSTEM=usb\0"
+	"DEVTYPE=usb_interface\0"
+	"DRIVER=usbhid\0"
+	"PRODUCT=b0e/e44/120\0"
+	"TYPE=0/0/0\0"
+	"INTERFACE=3/0/0\0"
+	"MODALIAS=usb:v0B0Ep0E44d0120dc00dsc00dp00ic03isc00ip00in00\0"
+	"SEQNUM=4424\0"s;
+
+UBENCH_CASE(parse_bench)
+{
+	uint64_t sum{0};
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto ev = Netlink::UEvent::parse(KernelBind);
+		sum += ev->seqnum();
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(parse_filtered_bench)
+{
+	auto filter = Netlink::UEventFilter{};
+	filter.add_match_subsystem_devtype("sound");
+	filter.add_match_subsystem_devtype("hidraw");
+
+	uint64_t sum{0};
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto ev = Netlink::UEvent::parse(KernelBind, filter);
+		sum += ev.has_value();
+	}
+	UBench::do_not_optimize(sum);
+}
+
+}}
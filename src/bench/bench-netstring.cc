@@ -0,0 +1,51 @@
+#include "ubench/macros.h"
+#include "io/buffer.h"
+#include "io/stream-buffer.h"
+#include "netstring/reader.h"
+#include "netstring/writer.h"
+
+#include <cstring>
+
+namespace benchmarks {
+namespace netstring {
+
+std::string message()
+{
+	return R"({"event":true,"class":"call","type":"CALL_RINGING",)"
+		R"("accountaor":"sip:9999-1@asterisk.example.com","direction":"outgoing",)"
+		R"("peeruri":"sip:7777@asterisk.example.com","id":"6d42101ce49915a3","param":""})";
+}
+
+UBENCH_CASE(reader_bench)
+{
+	auto msg = message();
+	auto netstring = std::to_string(msg.size()) + ":" + msg + ",";
+	auto buf = IO::Buffer{netstring.size()};
+	auto stream = IO::StreamBuffer{buf};
+	auto reader = Netstring::Reader{stream};
+	auto out = std::string{};
+	state.set_bytes(netstring.size());
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		buf.reserve(netstring.size());
+		std::memcpy(buf.wstart(), netstring.data(), netstring.size());
+		buf.fill(netstring.size());
+		reader.parse(out);
+		UBench::do_not_optimize(out);
+	}
+}
+
+UBENCH_CASE(writer_bench)
+{
+	auto msg = message();
+	auto buf = IO::Buffer{4096};
+	state.set_bytes(msg.size());
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		Netstring::write(buf, msg);
+		UBench::do_not_optimize(buf.rstart());
+		buf.drain(buf.rsize());
+	}
+}
+
+}}
@@ -0,0 +1,97 @@
+#include "ubench/macros.h"
+#include "signals.h"
+#include "static-signal.h"
+
+#include <vector>
+
+namespace benchmarks {
+namespace signals {
+
+UBENCH_CASE(emit_one_bench)
+{
+	Signal<void(int)> sig;
+	int sum{0};
+	auto conn = AutoConnection{sig.connect([&sum](int n) { sum += n; })};
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		sig(1);
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(emit_many_bench)
+{
+	Signal<void(int)> sig;
+	int sum{0};
+	auto conns = std::vector<AutoConnection>{};
+	for (size_t n{0}; n < 8; ++n) {
+		conns.emplace_back(sig.connect([&sum](int n) { sum += n; }));
+	}
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		sig(1);
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(connect_disconnect_bench)
+{
+	Signal<void(int)> sig;
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto conn = sig.connect([](int) { });
+		conn.disconnect();
+	}
+}
+
+// a filter stage in front of a sink, wired dynamically and statically
+namespace {
+
+struct Stage {
+	bool pass(int n) const
+	{
+		return n >= 0;
+	}
+
+	void sink(int n)
+	{
+		sum += n;
+	}
+
+	int sum = 0;
+};
+
+}
+
+UBENCH_CASE(dynamic_chain_bench)
+{
+	Stage stage;
+	Signal<void(int)> in;
+	Signal<void(int)> forward;
+	auto c1 = AutoConnection{in.connect([&stage, &forward](int n) {
+		if (stage.pass(n)) {
+			forward(n);
+		}
+	})};
+	auto c2 = AutoConnection{forward.connect([&stage](int n) { stage.sink(n); })};
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		in(1);
+	}
+	UBench::do_not_optimize(stage.sum);
+}
+
+UBENCH_CASE(static_chain_bench)
+{
+	Stage stage;
+	auto in = StaticSignal{
+		member_slot<&Stage::pass>(stage),
+		member_slot<&Stage::sink>(stage)};
+
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		in(1);
+	}
+	UBench::do_not_optimize(stage.sum);
+}
+
+}}
@@ -0,0 +1,79 @@
+#include "ubench/macros.h"
+#include "udev-device-snapshot.h"
+
+#include <map>
+#include <string>
+
+namespace benchmarks {
+namespace udev_device_snapshot {
+
+using List = UDev::DeviceSnapshot::List;
+
+// properties of a typical USB audio device
+char const* const Properties[][2] = {
+	{"ACTION", "add"},
+	{"BUSNUM", "001"},
+	{"DEVNAME", "/dev/bus/usb/001/004"},
+	{"DEVNUM", "004"},
+	{"DEVPATH", "/devices/pci0000:00/0000:00:14.0/usb1/1-2"},
+	{"DEVTYPE", "usb_device"},
+	{"DRIVER", "usb"},
+	{"ID_BUS", "usb"},
+	{"ID_MODEL", "Jabra_SPEAK_510_USB"},
+	{"ID_MODEL_ID", "0420"},
+	{"ID_REVISION", "0214"},
+	{"ID_SERIAL", "0b0e_Jabra_SPEAK_510_USB_501AA5D8ACDB021A00"},
+	{"ID_USB_INTERFACES", ":010100:010200:030000:"},
+	{"ID_VENDOR", "0b0e"},
+	{"ID_VENDOR_ID", "0b0e"},
+	{"MAJOR", "189"},
+	{"MINOR", "3"},
+	{"PRODUCT", "b0e/420/214"},
+	{"SUBSYSTEM", "usb"},
+	{"TYPE", "0/0/0"},
+};
+
+UBENCH_CASE(map_copy_bench)
+{
+	// what every properties() call did before
+	size_t sum{0};
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		auto props = std::map<std::string, std::string>{};
+		for (auto const& prop : Properties) {
+			props.insert({std::string{prop[0]}, std::string{prop[1]}});
+		}
+		sum += props["ID_VENDOR_ID"].size() + props["ID_MODEL_ID"].size();
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(build_bench)
+{
+	size_t sum{0};
+	auto builder = UDev::DeviceSnapshot::Builder{};
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		for (auto const& prop : Properties) {
+			builder.add(List::Properties, prop[0], prop[1]);
+		}
+		auto snapshot = builder.build();
+		sum += snapshot.properties().size();
+	}
+	UBench::do_not_optimize(sum);
+}
+
+UBENCH_CASE(lookup_bench)
+{
+	auto builder = UDev::DeviceSnapshot::Builder{};
+	for (auto const& prop : Properties) {
+		builder.add(List::Properties, prop[0], prop[1]);
+	}
+	auto snapshot = builder.build();
+
+	size_t sum{0};
+	for (uint64_t i{0}; i < state.iterations(); ++i) {
+		sum += snapshot.property_value("ID_VENDOR_ID").size() + snapshot.property_value("ID_MODEL_ID").size();
+	}
+	UBench::do_not_optimize(sum);
+}
+
+}}
@@ -0,0 +1,111 @@
+#include "ubench/registry.h"
+#include "ubench/runner.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <sched.h>
+#include <unistd.h>
+
+namespace {
+
+void pin_cpu(int cpu)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (::sched_setaffinity(0, sizeof(set), &set) != 0) {
+		std::cerr << "failed to pin to cpu " << cpu << "\n";
+	}
+}
+
+void write_json(std::ostream & os, std::vector<UBench::Result> const& results)
+{
+	os << std::fixed << std::setprecision(3) << "{\"benchmarks\":[";
+	for (size_t i{0}; i < results.size(); ++i) {
+		auto const& res = results[i];
+		os << (i ? "," : "") << "\n{"
+			<< "\"name\":\"" << res.name << "\","
+			<< "\"iterations\":" << res.iterations << ","
+			<< "\"repetitions\":" << res.repetitions << ","
+			<< "\"ns_per_op\":" << res.median_ns << ","
+			<< "\"min_ns_per_op\":" << res.min_ns << ","
+			<< "\"max_ns_per_op\":" << res.max_ns << ","
+			<< "\"bytes_per_second\":" << res.bytes_per_second << "}";
+	}
+	os << "\n]}\n";
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	auto list{false};
+	std::string benchname;
+	std::string output;
+	auto params = UBench::Params{};
+	int opt;
+
+	while ((opt = getopt(argc, argv, "lb:o:r:t:c:")) != -1) {
+		switch (opt) {
+		case 'l':
+			list = true;
+			break;
+		case 'b':
+			benchname = optarg;
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		case 'r':
+			params.repetitions = std::strtoul(optarg, nullptr, 10);
+			break;
+		case 't':
+			params.min_time = std::chrono::milliseconds(std::strtoul(optarg, nullptr, 10));
+			break;
+		case 'c':
+			pin_cpu(std::atoi(optarg));
+			break;
+		default: /* '?' */
+			std::cerr << "Usage:" << argv[0]
+				<< " [-l] [-b name] [-o file.json] [-r repetitions] [-t min ms] [-c cpu]\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (list) {
+		for (auto const& bench : UBench::Registry::get()) {
+			std::cout << bench.name << "\n";
+		}
+		return EXIT_SUCCESS;
+	}
+
+	auto results = std::vector<UBench::Result>{};
+	for (auto const& bench : UBench::Registry::get()) {
+		if (!benchname.empty() && bench.name.find(benchname) == std::string::npos) {
+			continue;
+		}
+
+		results.push_back(UBench::run(bench, params));
+		auto const& res = results.back();
+		std::cerr << std::fixed << std::setprecision(2) << std::left
+			<< std::setw(48) << res.name << " " << std::right
+			<< std::setw(12) << res.median_ns << " ns/op";
+		if (res.bytes_per_second > 0) {
+			std::cerr << std::setw(12) << res.bytes_per_second / (1024 * 1024) << " MiB/s";
+		}
+		std::cerr << "\n";
+	}
+
+	if (output.empty()) {
+		write_json(std::cout, results);
+	} else {
+		auto os = std::ofstream{output};
+		write_json(os, results);
+	}
+
+	return EXIT_SUCCESS;
+}
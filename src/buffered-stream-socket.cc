@@ -1,68 +1,205 @@
 #include "buffered-stream-socket.h"
 
 #include "posix/socket.h"
+#include "posix/timer-fd.h"
+
+#include <sys/socket.h>
+
+#include <system_error>
+
+namespace {
+
+Posix::SocketFactory::Params::Domain socket_domain(Posix::SocketAddress const& addr)
+{
+	switch (addr.family()) {
+	case AF_UNIX:
+		return Posix::SocketFactory::Params::Domain::Unix;
+	case AF_INET6:
+		return Posix::SocketFactory::Params::Domain::Inet6;
+	default:
+		return Posix::SocketFactory::Params::Domain::Inet;
+	}
+}
+
+}
 
 BufferedStreamSocket::BufferedStreamSocket(
 	EPoll::Ctrl & poller,
 	Posix::SocketFactory & socket_factory,
+	Posix::TimerFdFactory & timerfd_factory,
 	Posix::SocketAddress const& addr)
+:
+	BufferedStreamSocket(poller, socket_factory, timerfd_factory, addr, Params{})
+{ }
+
+BufferedStreamSocket::BufferedStreamSocket(
+	EPoll::Ctrl & poller,
+	Posix::SocketFactory & socket_factory,
+	Posix::TimerFdFactory & timerfd_factory,
+	Posix::SocketAddress const& addr,
+	Params const& params)
 :
 	sendbuf_{4096},
-	recvbuf_{4096},
-	socket_(socket_factory.make_stream_socket({
-		Posix::SocketFactory::Params::Domain::Inet,
-		Posix::SocketFactory::Params::Type::Stream,
-		Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec})),
-	ev_{poll_events()},
+	recvbuf_{ReadSize},
+	socket_factory_(socket_factory),
+	addr_(addr),
+	params_(params),
+	backoff_(params.min_backoff, params.max_backoff, params.jitter),
+	timer_(timerfd_factory.make_timerfd(Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec)),
 	poller_(poller)
 {
-	connect(addr);
+	sendbuf_.on_fill([this] () { schedule_flush(); });
+	sendbuf_.on_drain([this] () { update_poll_events(); });
+	recvbuf_.on_drain([this] () {
+		reclaim_recvbuf();
+		update_poll_events();
+	});
 
-	recvbuf_.on_drain([this] () { update_poll_events(); });
+	poller_.add(timer_, EPoll::Events{EPoll::Event::In}, [this] (auto const&) { on_timer(); });
 
-	poller.add(socket_, ev_, [this] (auto ev) {
-		if (!ev) {
-			return;
-		}
+	connect();
+}
+
+BufferedStreamSocket::~BufferedStreamSocket()
+{
+	if (socket_) {
+		poller_.del(socket_);
+	}
+	poller_.del(timer_);
+}
 
-		if (socket_->state() == Posix::StreamSocket::State::in_progress) {
-			socket_->connect_continue();
-			update_poll_events();
+void BufferedStreamSocket::on_event(EPoll::Events const& ev)
+{
+	if (!ev) {
+		return;
+	}
+
+	if (state_ == State::connecting) {
+		try {
+			if (socket_->state() == Posix::StreamSocket::State::in_progress) {
+				socket_->connect_continue();
+			}
+		} catch (std::system_error const& e) {
+			disconnect(e.what());
 			return;
 		}
+		connected();
+		update_poll_events();
+		return;
+	}
 
-		dispatch(ev, {
-			{EPoll::Event::RdHup, [] () { throw std::runtime_error("RDHUP"); }},
-			{EPoll::Event::Pri,   [] () { throw std::runtime_error("PRI"); }},
-			{EPoll::Event::Err,   [] () { throw std::runtime_error("ERR"); }},
-			{EPoll::Event::Hup,   [] () { throw std::runtime_error("HUP"); }},
-			{EPoll::Event::In,    [this] () { on_readable(); }},
-			{EPoll::Event::Out,   [this] () { on_writable(); }}
-		});
+	// read before looking at Hup/Err to get the data sent right before
+	// the peer closed the connection
+	if (ev & EPoll::Event::In) {
+		on_readable();
+	}
+	if (state_ == State::connected && ev & EPoll::Event::Out) {
+		on_writable();
+	}
+	if (state_ == State::connected && ev & EPoll::Event::Err) {
+		disconnect(socket_->get_socket_error().message());
+	}
+	if (state_ == State::connected && ev & EPoll::Event::Hup) {
+		disconnect("HUP");
+	}
 
-		update_poll_events();
-	});
+	update_poll_events();
 }
 
 void BufferedStreamSocket::on_readable()
 {
-	auto size = socket_->read(recvbuf_.wstart(), recvbuf_.wsize());
+	size_t size{0};
+	try {
+		size = socket_->read(recvbuf_.wstart(), recvbuf_.wsize());
+	} catch (std::system_error const& e) {
+		if (e.code() != std::errc::resource_unavailable_try_again) {
+			disconnect(e.what());
+		}
+		return;
+	}
+
 	if (size == 0) {
-		// FIXME
-		throw std::runtime_error("Connection closed");
+		disconnect("Connection closed");
+		return;
 	}
 	recvbuf_.fill(size);
+	reclaim_recvbuf();
+}
+
+void BufferedStreamSocket::reclaim_recvbuf()
+{
+	// The buffer counts as full as long as its tail is used, even if
+	// the data in front of it was drained already. Move the remaining
+	// data to the front, otherwise reading stalls. This never grows the
+	// buffer, so unread data still throttles the socket.
+	if (recvbuf_.full() && recvbuf_.rsize() < ReadSize) {
+		recvbuf_.reserve(ReadSize - recvbuf_.rsize());
+	}
 }
 
 void BufferedStreamSocket::on_writable()
 {
-	auto size = socket_->write(sendbuf_.rstart(), sendbuf_.rsize());
+	size_t size{0};
+	try {
+		size = socket_->write(sendbuf_.rstart(), sendbuf_.rsize());
+	} catch (std::system_error const& e) {
+		if (e.code() != std::errc::resource_unavailable_try_again) {
+			disconnect(e.what());
+		}
+		return;
+	}
 	sendbuf_.drain(size);
 }
 
-void BufferedStreamSocket::connect(Posix::SocketAddress const& addr)
+void BufferedStreamSocket::on_timer()
 {
-	socket_->connect(addr);
+	if (timer_->expirations() != 0 && state_ == State::disconnected) {
+		connect();
+	}
+}
+
+void BufferedStreamSocket::schedule_flush()
+{
+	if (flush_scheduled_) {
+		return;
+	}
+
+	flush_scheduled_ = true;
+	poller_.defer([self = std::weak_ptr<BufferedStreamSocket *>(self_)] () {
+		auto sock = self.lock();
+		if (!sock) {
+			return;
+		}
+
+		auto & that = **sock;
+		that.flush_scheduled_ = false;
+		if (that.state_ == State::connected && !that.sendbuf_.empty()) {
+			that.on_writable();
+		}
+		that.update_poll_events();
+	});
+}
+
+void BufferedStreamSocket::connect()
+{
+	socket_ = socket_factory_.make_stream_socket({
+		socket_domain(addr_),
+		Posix::SocketFactory::Params::Type::Stream,
+		Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec});
+
+	if (addr_.family() != AF_UNIX) {
+		// writes are coalesced already, don't let Nagle delay them
+		socket_->set_nodelay(true);
+	}
+
+	try {
+		socket_->connect(addr_);
+	} catch (std::system_error const& e) {
+		socket_.reset();
+		timer_->set(backoff_.next());
+		on_disconnect_(e.what());
+		return;
+	}
 
 	switch (socket_->state()) {
 	case Posix::StreamSocket::State::init:
@@ -73,10 +210,43 @@ void BufferedStreamSocket::connect(Posix::SocketAddress const& addr)
 	case Posix::StreamSocket::State::connected:
 		break;
 	}
+
+	// even a connection established right away (usually AF_UNIX) is
+	// reported from the event loop once the socket is writable, so
+	// on_connect is never emitted from within the constructor
+	state_ = State::connecting;
+	ev_ = poll_events();
+	poller_.add(socket_, ev_, [this] (auto const& ev) { on_event(ev); });
+}
+
+void BufferedStreamSocket::connected()
+{
+	state_ = State::connected;
+	backoff_.reset();
+	on_connect_();
+}
+
+void BufferedStreamSocket::disconnect(std::string const& reason)
+{
+	poller_.del(socket_);
+	socket_.reset();
+	state_ = State::disconnected;
+
+	recvbuf_.drain(recvbuf_.rsize());
+	if (!params_.replay) {
+		sendbuf_.drain(sendbuf_.rsize());
+	}
+
+	timer_->set(backoff_.next());
+	on_disconnect_(reason);
 }
 
 void BufferedStreamSocket::update_poll_events()
 {
+	if (!socket_) {
+		return;
+	}
+
 	if (auto ev = poll_events(); ev != ev_) {
 		ev_ = ev;
 		poller_.mod(socket_, ev_);
@@ -85,7 +255,7 @@ void BufferedStreamSocket::update_poll_events()
 
 EPoll::Events BufferedStreamSocket::poll_events() const
 {
-	if (socket_->state() == Posix::StreamSocket::State::in_progress) {
+	if (state_ == State::connecting) {
 		return EPoll::Events{EPoll::Event::Out};
 	}
 
@@ -1,23 +1,71 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <string>
 
+#include "backoff.h"
 #include "io/event-buffer.h"
 #include "epoll/ctrl.h"
+#include "posix/socket-address.h"
+#include "signals.h"
 
 namespace Posix {
 class SocketFactory;
-class SocketAddress;
 class StreamSocket;
+class TimerFd;
+class TimerFdFactory;
 }
 
+// Buffered non-blocking stream socket which keeps itself connected.
+//
+// A closed or failed connection is torn down, reported through
+// on_disconnect and reestablished after a jittered exponential backoff.
+// Received data of the lost connection is discarded, unsent data is
+// either discarded or kept and sent on the new connection (replay).
+//
+// Data put into the send buffer is written once per event loop
+// iteration, so messages queued by all callbacks of one wakeup leave
+// in a single write() without waiting for another epoll round trip.
 class BufferedStreamSocket {
 public:
+	struct Params {
+		std::chrono::milliseconds min_backoff{10};
+		std::chrono::milliseconds max_backoff{1000};
+		double jitter = 0.5;
+		// keep unsent data across reconnects, only useful if the peer
+		// can cope with a message that was partially written to the
+		// previous connection
+		bool replay = false;
+	};
+
+	enum class State {
+		connecting,
+		connected,
+		disconnected,
+	};
+
 	BufferedStreamSocket(
 		EPoll::Ctrl &,
 		Posix::SocketFactory &,
+		Posix::TimerFdFactory &,
 		Posix::SocketAddress const&);
 
+	BufferedStreamSocket(
+		EPoll::Ctrl &,
+		Posix::SocketFactory &,
+		Posix::TimerFdFactory &,
+		Posix::SocketAddress const&,
+		Params const&);
+
+	BufferedStreamSocket(BufferedStreamSocket const&) = delete;
+	BufferedStreamSocket & operator=(BufferedStreamSocket const&) = delete;
+
+	~BufferedStreamSocket();
+
+	SignalProxy<void()> & on_connect{on_connect_};
+	SignalProxy<void(std::string const&)> & on_disconnect{on_disconnect_};
+
 	IO::ReadEventBuffer & recvbuf()
 	{
 		return recvbuf_;
@@ -28,16 +76,40 @@ public:
 		return sendbuf_;
 	}
 
+	State state() const
+	{
+		return state_;
+	}
+
 private:
+	static constexpr size_t ReadSize = 4096;
+
+	void on_event(EPoll::Events const&);
 	void on_readable();
 	void on_writable();
-	void connect(Posix::SocketAddress const&);
+	void on_timer();
+	void reclaim_recvbuf();
+	void schedule_flush();
+	void connect();
+	void connected();
+	void disconnect(std::string const&);
 	void update_poll_events();
 	EPoll::Events poll_events() const;
 
 	IO::EventBuffer sendbuf_;
 	IO::EventBuffer recvbuf_;
+	Posix::SocketFactory & socket_factory_;
+	Posix::SocketAddress addr_;
+	Params params_;
+	Backoff backoff_;
+	State state_ = State::disconnected;
 	std::shared_ptr<Posix::StreamSocket> socket_;
+	std::shared_ptr<Posix::TimerFd> timer_;
 	EPoll::Events ev_;
+	bool flush_scheduled_ = false;
+	// expires with this object, guards deferred flushes
+	std::shared_ptr<BufferedStreamSocket *> self_{std::make_shared<BufferedStreamSocket *>(this)};
 	EPoll::Ctrl & poller_;
+	Signal<void()> on_connect_;
+	Signal<void(std::string const&)> on_disconnect_;
 };
@@ -0,0 +1,82 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "child-supervisor.h"
+
+#include "posix/fd.h"
+#include "posix/pid.h"
+#include "posix/timer-fd.h"
+
+#include <stdexcept>
+#include <system_error>
+
+ChildSupervisor::ChildSupervisor(
+	EPoll::Ctrl & poller,
+	Posix::TimerFdFactory & timerfd_factory,
+	Params const& params)
+:
+	params_(params),
+	backoff_(params.min_backoff, params.max_backoff),
+	timer_(timerfd_factory.make_timerfd(Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec)),
+	poller_(poller)
+{
+	poller_.add(timer_, EPoll::Events{EPoll::Event::In}, [this] (auto const&) { on_timer(); });
+}
+
+ChildSupervisor::~ChildSupervisor()
+{
+	if (pid_) {
+		poller_.del(pid_->fd());
+	}
+	poller_.del(timer_);
+}
+
+void ChildSupervisor::start()
+{
+	if (pid_) {
+		throw std::runtime_error("child already running");
+	}
+
+	timer_->cancel();
+	pid_ = Posix::Pid::spawn(params_.argv);
+	started_ = Clock::now();
+	poller_.add(pid_->fd(), EPoll::Events{EPoll::Event::In}, [this] (auto const&) { on_child_exit(); });
+	on_start_(pid_);
+}
+
+std::shared_ptr<Posix::Pid> ChildSupervisor::pid() const
+{
+	return pid_;
+}
+
+void ChildSupervisor::on_child_exit()
+{
+	auto pid = std::exchange(pid_, {});
+	poller_.del(pid->fd());
+	auto status = pid->wait(Posix::Wait::Option::NoHang);
+
+	if (Clock::now() - started_ >= params_.stable) {
+		backoff_.reset();
+	}
+	timer_->set(backoff_.next());
+
+	on_exit_(status);
+}
+
+void ChildSupervisor::on_timer()
+{
+	if (timer_->expirations() == 0 || pid_) {
+		return;
+	}
+
+	// the binary may be back on the next attempt, e.g. while it is
+	// being replaced, don't let this take down the event loop
+	try {
+		start();
+	} catch (std::system_error const& e) {
+		timer_->set(backoff_.next());
+		on_error_(e.what());
+	}
+}
@@ -0,0 +1,70 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "backoff.h"
+#include "epoll/ctrl.h"
+#include "posix/wait.h"
+#include "signals.h"
+
+namespace Posix {
+class Pid;
+class TimerFd;
+class TimerFdFactory;
+}
+
+// Runs a child process and restarts it with exponential backoff
+// whenever it exits. Exits are noticed through the pidfd of the child
+// in the event loop, so there is no SIGCHLD handling involved. A failed
+// restart is reported through on_error and retried after the next
+// backoff interval.
+class ChildSupervisor {
+public:
+	struct Params {
+		std::vector<std::string> argv;
+		std::chrono::milliseconds min_backoff{10};
+		std::chrono::milliseconds max_backoff{10000};
+		// a child running at least this long resets the backoff
+		std::chrono::milliseconds stable{10000};
+	};
+
+	ChildSupervisor(EPoll::Ctrl &, Posix::TimerFdFactory &, Params const&);
+
+	ChildSupervisor(ChildSupervisor const&) = delete;
+	ChildSupervisor & operator=(ChildSupervisor const&) = delete;
+
+	// stops supervision, a running child is not killed
+	~ChildSupervisor();
+
+	SignalProxy<void(std::shared_ptr<Posix::Pid> const&)> & on_start{on_start_};
+	SignalProxy<void(Posix::Wait::Status const&)> & on_exit{on_exit_};
+	SignalProxy<void(std::string const&)> & on_error{on_error_};
+
+	// throws if the child cannot be spawned
+	void start();
+	std::shared_ptr<Posix::Pid> pid() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void on_child_exit();
+	void on_timer();
+
+	Params params_;
+	Backoff backoff_;
+	std::shared_ptr<Posix::Pid> pid_;
+	Clock::time_point started_;
+	std::shared_ptr<Posix::TimerFd> timer_;
+	EPoll::Ctrl & poller_;
+	Signal<void(std::shared_ptr<Posix::Pid> const&)> on_start_;
+	Signal<void(Posix::Wait::Status const&)> on_exit_;
+	Signal<void(std::string const&)> on_error_;
+};
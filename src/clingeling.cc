@@ -4,85 +4,167 @@
    license that can be found in the LICENSE file.
 */
 #include "epoll/ctrl.h"
+#include "posix/fd.h"
+#include "posix/pid.h"
 #include "posix/socket.h"
-#include "posix/inet-address.h"
 #include "posix/socket-address.h"
-#include "posix/pipe-factory.h"
+#include "posix/system-error.h"
+#include "posix/signal.h"
+#include "posix/signal-fd.h"
+#include "posix/timer-fd.h"
 #include "buffered-stream-socket.h"
+#include "child-supervisor.h"
+#include "signal-handler.h"
 #include "baresip/ctrl.h"
+#include "baresip/event-filter.h"
+#include "baresip/journal.h"
 #include "baresip/model.h"
 #include "source-location.h"
+#include "static-signal.h"
+#include "fmt.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+struct Options {
+	// host:port, /unix/socket/path or @abstract-name
+	std::string baresip = "127.0.0.1:4444";
+	// record all baresip events to this file if not empty
+	std::string journal;
+	// run and supervise baresip with these arguments if not empty
+	std::vector<std::string> command;
+};
 
-struct EventPipe {
-public:
-	SignalProxy<void(void)> & on_event{on_event_};
-	SlotProxy<void(EPoll::Events const&)> & on_fd_event{on_fd_event_};
-
-	explicit EventPipe(Posix::Pipe const& pipe)
-	:
-		pipe_{pipe},
-		on_fd_event_{[this](auto const& ev) { handle_fd_event(ev); }}
-	{ }
-
-	void trigger()
-	{
-		int wakeup{0};
-		std::get<1>(pipe_)->write(&wakeup, sizeof(wakeup));
+Options parse_options(int argc, char *argv[])
+{
+	auto res = Options{};
+	int opt;
+	while ((opt = ::getopt(argc, argv, "b:j:")) != -1) {
+		switch (opt) {
+		case 'b':
+			res.baresip = optarg;
+			break;
+		case 'j':
+			res.journal = optarg;
+			break;
+		default:
+			throw std::runtime_error(FMT_FORMAT("usage: %s [-b baresip address] [-j journal] [-- baresip command]", argv[0]));
+		}
+	}
+	for (int i{optind}; i < argc; ++i) {
+		res.command.push_back(argv[i]);
 	}
+	return res;
+}
 
-	std::shared_ptr<Posix::Fd> fd() const
-	{
-		return std::get<0>(pipe_);
+std::unique_ptr<Baresip::Journal::Writer> open_journal(std::string const& path)
+{
+	if (path.empty()) {
+		return {};
 	}
 
-	EPoll::Events ev() const
-	{
-		return EPoll::Events{EPoll::Event::In};
+	int fd = ::open(path.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0644);
+	if (fd < 0) {
+		throw POSIX_SYSTEM_ERROR("open(%s)", path);
 	}
+	return std::make_unique<Baresip::Journal::Writer>(Posix::Fd::create(fd));
+}
 
-private:
-	void handle_fd_event(EPoll::Events const& ev)
-	{
-		if (ev != EPoll::Event::In) {
-			throw std::runtime_error("bad epoll event");
-		}
+std::string describe(Posix::Wait::Status const& status)
+{
+	if (status.exited()) {
+		return FMT_FORMAT("exited with %s", status.exit_status());
+	}
+	if (status.signaled()) {
+		return FMT_FORMAT("killed by signal %s", status.termsig());
+	}
+	return "stopped";
+}
 
-		int wakeup{0};
-		auto res = std::get<0>(pipe_)->read(&wakeup, sizeof(wakeup));
-		if (res == sizeof(wakeup)) {
-			on_event_();
-			return;
-		}
-		throw std::runtime_error("bad read from pipe");
+std::unique_ptr<ChildSupervisor> supervise(EPoll::Ctrl & poller, Posix::TimerFdFactory & timerfd_factory,
+	std::vector<std::string> const& command)
+{
+	if (command.empty()) {
+		return {};
 	}
 
-	Posix::Pipe pipe_;
-	Signal<void(void)> on_event_;
-	Slot<void(EPoll::Events const&)> on_fd_event_;
-};
+	auto params = ChildSupervisor::Params{};
+	params.argv = command;
+	auto res = std::make_unique<ChildSupervisor>(poller, timerfd_factory, params);
+	res->on_exit.connect([](auto const& status) {
+		std::cerr << "baresip " << describe(status) << "\n";
+	});
+	res->on_error.connect([](auto const& what) {
+		std::cerr << "failed to restart baresip: " << what << "\n";
+	});
+	return res;
+}
 
-int clingeling(int, char *[])
+}
+
+int clingeling(int argc, char *argv[])
 {
+	auto options = parse_options(argc, argv);
+
 	auto poller_factory = EPoll::CtrlFactory::create();
-	auto poller = poller_factory->make_ctrl();
+	auto poller = poller_factory->make_ctrl({true});
 
 	auto socket_factory = Posix::SocketFactory::create();
+	auto timerfd_factory = Posix::TimerFdFactory::create();
+
+	// started before connecting, the socket keeps retrying with backoff
+	// until baresip listens and reconnects after every restart
+	auto baresip = supervise(*poller, *timerfd_factory, options.command);
+	if (baresip) {
+		baresip->start();
+	}
 
 	auto socket_buffer = BufferedStreamSocket(
-		*poller, *socket_factory, Posix::SocketAddress{Posix::Inet::Address{"127.0.0.1"}, 4444});
+		*poller, *socket_factory, *timerfd_factory,
+		Posix::parse_socket_address(options.baresip));
 
 	auto baresip_ctrl = Baresip::Ctrl::create(socket_buffer.recvbuf(), socket_buffer.sendbuf());
+	auto journal = open_journal(options.journal);
+	if (journal) {
+		baresip_ctrl->on_event.connect([&journal](auto const& ev) { journal->write(ev); });
+	}
 
+	auto event_filter = Baresip::EventFilter::create();
 	auto baresip_model = Baresip::Model::create();
-	connect(baresip_model->on_event, baresip_ctrl->on_event);
 
-	auto pipe_factory = Posix::PipeFactory::create();
-	auto pipe = pipe_factory->make_pipe(Posix::PipeFactory::Params{false, true});
+	// the core pipeline never changes, call its stages directly
+	auto pipeline = StaticSignal{
+		member_slot<&Baresip::EventFilter::pass>(*event_filter),
+		member_slot<&Baresip::Model::handle>(*baresip_model)};
+	baresip_ctrl->on_event.connect(std::ref(pipeline));
+
+	socket_buffer.on_disconnect.connect([&baresip_ctrl, &event_filter](auto const& reason) {
+		std::cerr << "baresip connection lost: " << reason << "\n";
+		baresip_ctrl->reset();
+		event_filter->reset();
+	});
+
+	// Pipe is just consumed, a write to a closed socket then fails
+	// with EPIPE and the socket reconnects
+	auto signalfd_factory = Posix::SignalFdFactory::create();
+	auto signals = SignalHandler(*poller, *signalfd_factory,
+		{Posix::Signal::Int, Posix::Signal::Term, Posix::Signal::Usr1, Posix::Signal::Pipe});
 
-	EventPipe wakeup(pipe);
 	auto run{true};
-	wakeup.on_event.connect([&run]() { run = false; });
-	poller->add(wakeup.fd(), wakeup.ev(), [&wakeup](auto const& ev) { wakeup.on_fd_event(ev); });
+	auto stop = [&run](auto, auto const&) { run = false; };
+	signals.on_signal(Posix::Signal::Int).connect(stop);
+	signals.on_signal(Posix::Signal::Term).connect(stop);
+	signals.on_signal(Posix::Signal::Usr1).connect([&poller, &event_filter](auto, auto const&) {
+		std::cerr << to_string(poller->stats());
+		std::cerr << "events: " << to_string(event_filter->stats()) << "\n";
+	});
 
 	try {
 		do {
@@ -92,5 +174,9 @@ int clingeling(int, char *[])
 		throw_backtrace();
 	}
 
+	if (baresip && baresip->pid()) {
+		baresip->pid()->kill(Posix::Signal::Term);
+	}
+
 	return 0;
 }
@@ -5,8 +5,11 @@
 */
 
 #include <cassert>
+#include <mutex>
+#include <vector>
 
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 #include "epoll/ctrl.h"
 #include "posix/fd.h"
@@ -21,28 +24,55 @@ std::chrono::milliseconds Ctrl::Infinity()
 
 class CtrlImpl : public Ctrl {
 public:
-	CtrlImpl();
+	explicit CtrlImpl(CtrlFactory::Params const&);
 
-	void add(std::shared_ptr<Posix::Fd> const&, Events const&, std::function<void(Events const&)> const&) override;
+	void add(std::shared_ptr<Posix::Fd> const&, Events const&, InlineFunction<void(Events const&)>) override;
 	void del(std::shared_ptr<Posix::Fd> const&) override;
 	void mod(std::shared_ptr<Posix::Fd> const&, Events const&) const override;
+	void defer(std::function<void()> const&) override;
+	void post(std::function<void()>) override;
 	bool wait(std::chrono::milliseconds const&) const override;
+	Stats stats() const override;
+	void reset_stats() override;
 
 private:
+	void dispatch(epoll_event const&) const;
+	void dispatch_instrumented(epoll_event const&) const;
+	bool run_deferred() const;
+	void run_posted();
 
 	struct Callback {
 		std::shared_ptr<Posix::Fd> fd;
-		std::function<void(Events const&)> fn;
+		InlineFunction<void(Events const&)> fn;
+		bool deleted = false;
 	};
 
 	std::unordered_map<int, std::unique_ptr<Callback>> cb_;
+	// callbacks deleted while dispatching, freed once all events of
+	// the current wait() are handled
+	mutable std::vector<std::unique_ptr<Callback>> deleted_;
+	mutable bool dispatching_ = false;
+	mutable std::vector<std::function<void()>> deferred_;
 	std::shared_ptr<Posix::Fd> fd_;
+	// eventfd signalled by post() to wake up wait()
+	std::shared_ptr<Posix::Fd> wakeup_;
+	std::mutex posted_mutex_;
+	std::vector<std::function<void()>> posted_;
+	bool instrument_ = false;
+	mutable Stats stats_;
 };
 
 }
 
 namespace {
 
+using Clock = std::chrono::steady_clock;
+
+uint64_t elapsed_ns(Clock::time_point const& start, Clock::time_point const& end)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
 uint32_t epoll_events(EPoll::Events const& ev)
 {
 	uint32_t res{0};
@@ -95,18 +125,25 @@ EPoll::Events epoll_events(uint32_t ev)
 
 namespace EPoll {
 
-CtrlImpl::CtrlImpl()
+CtrlImpl::CtrlImpl(CtrlFactory::Params const& params)
 :
-	fd_(Posix::Fd::create(::epoll_create1(EPOLL_CLOEXEC)))
+	fd_(Posix::Fd::create(::epoll_create1(EPOLL_CLOEXEC))),
+	instrument_(params.instrument)
 {
 	if (fd_->get() == -1) {
 		throw POSIX_SYSTEM_ERROR("%s", "::epoll_create1(EPOLL_CLOEXEC)");
 	}
+
+	wakeup_ = Posix::Fd::create(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+	if (wakeup_->get() == -1) {
+		throw POSIX_SYSTEM_ERROR("%s", "::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)");
+	}
+	add(wakeup_, Events{Event::In}, [this] (auto const&) { run_posted(); });
 }
 
-void CtrlImpl::add(std::shared_ptr<Posix::Fd> const& fd, Events const& ev, std::function<void(Events const&)> const& fn)
+void CtrlImpl::add(std::shared_ptr<Posix::Fd> const& fd, Events const& ev, InlineFunction<void(Events const&)> fn)
 {
-	auto cb = std::unique_ptr<Callback>(new Callback{fd, fn});
+	auto cb = std::unique_ptr<Callback>(new Callback{fd, std::move(fn)});
 	epoll_event epoll_ev;
 	epoll_ev.events = ::epoll_events(ev);
 	epoll_ev.data.ptr = cb.get();
@@ -115,15 +152,21 @@ void CtrlImpl::add(std::shared_ptr<Posix::Fd> const& fd, Events const& ev, std::
 	}
 	auto res = cb_.emplace(fd->get(), std::move(cb));
 	if (!res.second) {
-		throw std::runtime_error(Fmt::format("Failed to add Fd %s, already present", fd->get()));
+		throw std::runtime_error(FMT_FORMAT("Failed to add Fd %s, already present", fd->get()));
 	}
 }
 
 void CtrlImpl::del(std::shared_ptr<Posix::Fd> const& fd)
 {
-	if (cb_.erase(fd->get()) == 0) {
+	auto it{cb_.find(fd->get())};
+	if (it == std::end(cb_)) {
 		throw std::runtime_error("could not find fd to delete");
 	}
+	if (dispatching_) {
+		it->second->deleted = true;
+		deleted_.push_back(std::move(it->second));
+	}
+	cb_.erase(it);
 	if (::epoll_ctl(fd_->get(), EPOLL_CTL_DEL, fd->get(), nullptr) == -1) {
 		throw POSIX_SYSTEM_ERROR("::epoll_ctl(%s, EPOLL_CTL_DEL, %s, nullptr)", fd_->get(), fd->get());
 	}
@@ -133,7 +176,7 @@ void CtrlImpl::mod(std::shared_ptr<Posix::Fd> const& fd, Events const& ev) const
 {
 	auto it{cb_.find(fd->get())};
 	if (it == std::end(cb_)) {
-		throw std::runtime_error(Fmt::format("could not find fd %s to modify", fd->get()));
+		throw std::runtime_error(FMT_FORMAT("could not find fd %s to modify", fd->get()));
 	}
 
 	epoll_event epoll_ev;
@@ -144,15 +187,54 @@ void CtrlImpl::mod(std::shared_ptr<Posix::Fd> const& fd, Events const& ev) const
 	}
 }
 
+void CtrlImpl::defer(std::function<void()> const& fn)
+{
+	deferred_.push_back(fn);
+}
+
+void CtrlImpl::post(std::function<void()> fn)
+{
+	bool idle{false};
+	{
+		auto lock = std::lock_guard<std::mutex>{posted_mutex_};
+		idle = posted_.empty();
+		posted_.push_back(std::move(fn));
+	}
+
+	// one wakeup per batch, the loop takes all queued functions at once
+	if (idle) {
+		uint64_t one{1};
+		wakeup_->write(&one, sizeof(one));
+	}
+}
+
+void CtrlImpl::run_posted()
+{
+	uint64_t count{0};
+	wakeup_->read(&count, sizeof(count));
+
+	auto fns = std::vector<std::function<void()>>{};
+	{
+		auto lock = std::lock_guard<std::mutex>{posted_mutex_};
+		std::swap(fns, posted_);
+	}
+	for (auto const& fn : fns) {
+		fn();
+	}
+}
+
 bool CtrlImpl::wait(std::chrono::milliseconds const& timeout = Infinity()) const
 {
 	int to = -1;
-	if (timeout != Infinity()) {
+	if (!deferred_.empty()) {
+		to = 0;
+	} else if (timeout != Infinity()) {
 		to = timeout.count();
 	}
 
 	auto events = std::array<epoll_event, 10>{};
 	int nevents{-1};
+	auto start = instrument_ ? Clock::now() : Clock::time_point{};
 	do {
 		nevents = ::epoll_wait(fd_->get(), events.data(), events.size(), to);
 	} while (nevents == -1 && errno == EINTR);
@@ -162,17 +244,76 @@ bool CtrlImpl::wait(std::chrono::milliseconds const& timeout = Infinity()) const
 	}
 
 	assert(nevents >= 0);
-	for (size_t n{0}; n < size_t(nevents); ++n) {
-		auto cb = static_cast<Callback*>(events[n].data.ptr);
-		cb->fn(::epoll_events(events[n].events));
+	dispatching_ = true;
+	if (!instrument_) {
+		for (size_t n{0}; n < size_t(nevents); ++n) {
+			dispatch(events[n]);
+		}
+	} else {
+		auto woken = Clock::now();
+		stats_.wait.record(elapsed_ns(start, woken));
+		stats_.events.record(nevents);
+		for (size_t n{0}; n < size_t(nevents); ++n) {
+			dispatch_instrumented(events[n]);
+		}
+		stats_.dispatch.record(elapsed_ns(woken, Clock::now()));
 	}
+	dispatching_ = false;
+	deleted_.clear();
 
-	return nevents != 0;
+	auto deferred = run_deferred();
+	return nevents != 0 || deferred;
+}
+
+bool CtrlImpl::run_deferred() const
+{
+	if (deferred_.empty()) {
+		return false;
+	}
+
+	// deferred work may defer more work, run that in this round too
+	auto fns = std::vector<std::function<void()>>{};
+	while (!deferred_.empty()) {
+		fns.clear();
+		std::swap(fns, deferred_);
+		for (auto const& fn : fns) {
+			fn();
+		}
+	}
+	return true;
+}
+
+void CtrlImpl::dispatch(epoll_event const& ev) const
+{
+	// skip events for callbacks deleted earlier in this round
+	auto cb = static_cast<Callback*>(ev.data.ptr);
+	if (!cb->deleted) {
+		cb->fn(::epoll_events(ev.events));
+	}
+}
+
+void CtrlImpl::dispatch_instrumented(epoll_event const& ev) const
+{
+	// the callback may delete itself, so don't touch it afterwards
+	auto fd = static_cast<Callback*>(ev.data.ptr)->fd->get();
+	auto start = Clock::now();
+	dispatch(ev);
+	stats_.handlers[fd].record(elapsed_ns(start, Clock::now()));
+}
+
+Ctrl::Stats CtrlImpl::stats() const
+{
+	return stats_;
+}
+
+void CtrlImpl::reset_stats()
+{
+	stats_ = Stats{};
 }
 
 class CtrlFactoryImpl : public CtrlFactory {
 public:
-	std::unique_ptr<Ctrl> make_ctrl() const override;
+	std::unique_ptr<Ctrl> make_ctrl(Params const&) const override;
 };
 
 std::unique_ptr<CtrlFactory> CtrlFactory::create()
@@ -180,9 +321,19 @@ std::unique_ptr<CtrlFactory> CtrlFactory::create()
 	return std::make_unique<CtrlFactoryImpl>();
 }
 
-std::unique_ptr<Ctrl> CtrlFactoryImpl::make_ctrl() const
+std::unique_ptr<Ctrl> CtrlFactoryImpl::make_ctrl(Params const& params) const
+{
+	return std::make_unique<CtrlImpl>(params);
+}
+
+std::string to_string(Ctrl::Stats const& stats)
 {
-	return std::make_unique<CtrlImpl>();
+	auto res = FMT_FORMAT("wait: %s\ndispatch: %s\nevents: %s\n",
+		to_string(stats.wait), to_string(stats.dispatch), to_string(stats.events));
+	for (auto const& handler : stats.handlers) {
+		res += FMT_FORMAT("fd %s: %s\n", handler.first, to_string(handler.second));
+	}
+	return res;
 }
 
 }
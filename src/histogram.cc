@@ -0,0 +1,61 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "histogram.h"
+#include "fmt.h"
+
+#include <algorithm>
+#include <cmath>
+
+uint64_t Histogram::highest_equivalent(size_t index)
+{
+	if (index < 2 * SubBuckets) {
+		return index;
+	}
+
+	auto shift = index / SubBuckets - 1;
+	auto sub = uint64_t(index % SubBuckets + SubBuckets);
+	return ((sub + 1) << shift) - 1;
+}
+
+uint64_t Histogram::percentile(double p) const
+{
+	if (count_ == 0) {
+		return 0;
+	}
+
+	auto rank = uint64_t(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * count_));
+	rank = std::max(rank, uint64_t(1));
+
+	uint64_t seen{0};
+	for (size_t i{0}; i < counts_.size(); ++i) {
+		seen += counts_[i];
+		if (seen >= rank) {
+			return std::min(highest_equivalent(i), max_);
+		}
+	}
+
+	return max_;
+}
+
+Histogram & Histogram::operator+=(Histogram const& o)
+{
+	for (size_t i{0}; i < counts_.size(); ++i) {
+		counts_[i] += o.counts_[i];
+	}
+	count_ += o.count_;
+	sum_ += o.sum_;
+	min_ = std::min(min_, o.min_);
+	max_ = std::max(max_, o.max_);
+	return *this;
+}
+
+std::string to_string(Histogram const& h)
+{
+	return FMT_FORMAT("count=%s min=%s mean=%s p50=%s p90=%s p99=%s p999=%s max=%s",
+		h.count(), h.min(), uint64_t(h.mean()), h.percentile(50.0), h.percentile(90.0),
+		h.percentile(99.0), h.percentile(99.9), h.max());
+}
@@ -0,0 +1,73 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+// Exponential backoff: initial, 2 * initial, 4 * initial ... up to max
+//
+// With a jitter j in [0, 1] each delay d is randomly shortened to a
+// value in [d * (1 - j), d], so peers that lost their connection at the
+// same time don't all come back in lockstep.
+class Backoff {
+public:
+	using Duration = std::chrono::milliseconds;
+
+	Backoff(Duration const& initial, Duration const& max, double jitter = 0.0)
+	:
+		initial_(initial),
+		max_(max),
+		next_(initial),
+		jitter_(std::clamp(jitter, 0.0, 1.0)),
+		rng_(std::random_device{}())
+	{ }
+
+	Duration next()
+	{
+		auto res = next_;
+		next_ = std::min(next_ * 2, max_);
+		if (jitter_ == 0.0) {
+			return res;
+		}
+
+		auto dist = std::uniform_real_distribution<double>(1.0 - jitter_, 1.0);
+		return Duration(Duration::rep(res.count() * dist(rng_)));
+	}
+
+	void reset()
+	{
+		next_ = initial_;
+	}
+
+private:
+	Duration initial_;
+	Duration max_;
+	Duration next_;
+	double jitter_;
+	std::minstd_rand rng_;
+};
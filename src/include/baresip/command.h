@@ -25,9 +25,18 @@
 */
 #pragma once
 
+#include <string>
+
 namespace Baresip {
 namespace Command {
 
+class Request {
+public:
+	std::string command;
+	std::string params;
+	std::string token;
+};
+
 class Response {
 public:
 	bool ok = false;
@@ -30,6 +30,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 namespace IO {
 class ReadEventBuffer;
@@ -38,16 +39,33 @@ class WriteBuffer;
 
 namespace Baresip {
 namespace Command {
+class Request;
 class Response;
 }
 
 class Ctrl {
 public:
+	using ResponseCallback = std::function<void(Command::Response const&)>;
+
 	static std::unique_ptr<Ctrl> create(IO::ReadEventBuffer &, IO::WriteBuffer &);
 
 	SignalProxy<void(Event::Any const&)> & on_event{on_event_};
 	SignalProxy<void(Command::Response const&)> & on_response{on_response_};
 
+	// Queue a command without waiting for the responses of earlier
+	// ones. The request is tagged with a new token ("cl-1", "cl-2", ...),
+	// unless it has one already, and cb is called with the response
+	// carrying that token. Returns the token.
+	virtual std::string send(Command::Request const&, ResponseCallback const& = {}) = 0;
+
+	// number of commands waiting for a response
+	virtual size_t pending() const = 0;
+
+	// drop the state of a partially received message, call this when
+	// the connection was lost and the receive buffer was discarded.
+	// Pending commands are completed with a failed response.
+	virtual void reset() = 0;
+
 	virtual ~Ctrl() = default;
 
 protected:
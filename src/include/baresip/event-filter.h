@@ -0,0 +1,75 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "baresip/event.h"
+#include "signals.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Baresip {
+
+// Drops events which repeat the last event of the same call or
+// account, e.g. a CALL_RINGING sent again by baresip. Forwarded events
+// are emitted unchanged through on_forward.
+//
+// The filter runs on parsed events, after Ctrl::on_event. It spares
+// the stages behind it, not the parsing: every subscriber of
+// Ctrl::on_event, e.g. the journal, still gets each event as sent.
+class EventFilter {
+public:
+	struct Stats {
+		uint64_t forwarded = 0;
+		uint64_t suppressed = 0;
+	};
+
+	static std::unique_ptr<EventFilter> create();
+
+	SlotProxy<void(Event::Any const&)> & on_event{on_event_};
+	SignalProxy<void(Event::Any const&)> & on_forward{on_forward_};
+
+	// Record ev and tell if it has to be forwarded. This is on_event
+	// without emitting on_forward, for wiring the filter statically.
+	virtual bool pass(Event::Any const& ev) = 0;
+
+	virtual Stats stats() const = 0;
+
+	// forget all seen events, call this when the connection to
+	// baresip was lost and its state has to be reported again
+	virtual void reset() = 0;
+
+	virtual ~EventFilter() = default;
+
+protected:
+	Slot<void(Event::Any const&)> on_event_;
+	Signal<void(Event::Any const&)> on_forward_;
+};
+
+std::string to_string(EventFilter::Stats const&);
+
+}
@@ -25,6 +25,8 @@
 */
 #pragma once
 
+#include "interned-string.h"
+
 #include <string>
 #include <variant>
 
@@ -40,7 +42,7 @@ public:
 	};
 
 	Type type;
-	std::string accountaor;
+	InternedString accountaor;
 	std::string param;
 };
 
@@ -59,7 +61,7 @@ public:
 	};
 
 	Type type;
-	std::string accountaor;
+	InternedString accountaor;
 	Direction direction;
 	std::string peeruri;
 	std::string id;
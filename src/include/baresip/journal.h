@@ -0,0 +1,92 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "baresip/event.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Posix {
+class Fd;
+}
+
+namespace Baresip {
+namespace Journal {
+
+/*
+   Append-only binary log of decoded events.
+
+   A journal starts with Magic followed by records. Each record is the
+   varint encoded size of its payload and the payload: the varint time
+   since the previous record in nanoseconds, the variant index of the
+   event and its fields. Enums are single bytes, strings are prefixed
+   with their varint encoded size. Records never point outside of
+   themselves, so a journal can be read straight from a mmapped file.
+*/
+
+constexpr std::string_view Magic{"CLJ1"};
+
+struct Record {
+	// steady clock time of the event
+	std::chrono::nanoseconds time;
+	Event::Any event;
+};
+
+class Writer {
+public:
+	// writes Magic to fd
+	explicit Writer(std::shared_ptr<Posix::Fd> const&);
+
+	// record an event with the current steady clock time
+	void write(Event::Any const&);
+	void write(Record const&);
+
+private:
+	std::shared_ptr<Posix::Fd> fd_;
+	// reused for every record
+	std::string payload_;
+	std::string buf_;
+	std::chrono::nanoseconds last_{0};
+};
+
+class Reader {
+public:
+	// throws std::runtime_error if data doesn't start with Magic
+	explicit Reader(std::string_view const&);
+
+	// Decodes the next record. Returns false at the end of the data,
+	// throws std::runtime_error if the record is truncated or invalid.
+	bool next(Record &);
+
+private:
+	std::string_view data_;
+	std::chrono::nanoseconds last_{0};
+};
+
+}}
@@ -26,8 +26,17 @@
 #pragma once
 
 #include "baresip/event.h"
+#include "interned-string.h"
 #include "signals.h"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace Baresip {
 
 class Call {
@@ -72,6 +81,8 @@ public:
 			return id.value_;
 		}
 
+		friend struct std::hash<Id>;
+
 		std::string value_;
 	};
 
@@ -80,8 +91,8 @@ public:
 	virtual Id id() const = 0;
 	virtual State state() const = 0;
 	virtual Direction direction() const = 0;
-	virtual std::string accountaor() const = 0;
-	virtual std::string peeruri() const = 0;
+	virtual std::string_view accountaor() const = 0;
+	virtual std::string_view peeruri() const = 0;
 
 	virtual ~Call() = default;
 
@@ -89,6 +100,58 @@ protected:
 	Signal<void(State)> on_state_change_;
 };
 
+// Immutable snapshot of a list of calls, copying it is O(1)
+class CallList {
+public:
+	using Calls = std::vector<std::shared_ptr<Call>>;
+	using const_iterator = Calls::const_iterator;
+
+	CallList();
+
+	explicit CallList(std::shared_ptr<Calls const> const& calls)
+	:
+		calls_(calls)
+	{ }
+
+	size_t size() const
+	{
+		return calls_->size();
+	}
+
+	bool empty() const
+	{
+		return calls_->empty();
+	}
+
+	std::shared_ptr<Call> const& operator[](size_t n) const
+	{
+		return (*calls_)[n];
+	}
+
+	std::shared_ptr<Call> const& front() const
+	{
+		return calls_->front();
+	}
+
+	std::shared_ptr<Call> const& back() const
+	{
+		return calls_->back();
+	}
+
+	const_iterator begin() const
+	{
+		return calls_->begin();
+	}
+
+	const_iterator end() const
+	{
+		return calls_->end();
+	}
+
+private:
+	std::shared_ptr<Calls const> calls_;
+};
+
 class Model {
 public:
 	static std::unique_ptr<Model> create();
@@ -99,18 +162,52 @@ public:
 		Fail,
 	};
 
+	struct Account {
+		InternedString aor;
+		Registration registration = Registration::Unknown;
+		// time of the last change of registration
+		std::chrono::steady_clock::time_point since;
+		// number of times a registered account failed
+		uint64_t flaps = 0;
+	};
+
 	SignalProxy<void(std::shared_ptr<Call> const&)> & on_call{on_call_};
 
+	// emitted when the registration of an account changes, repeated
+	// events with the same outcome are not reported
+	SignalProxy<void(Account const&)> & on_registration{on_registration_};
+
 	SlotProxy<void(Event::Any const&)> & on_event{on_event_};
 
+	// same as on_event, for wiring the model statically
+	virtual void handle(Event::Any const&) = 0;
+
+	// Closed calls are kept in a history of this many entries
+	static constexpr size_t HistorySize = 16;
+
+	// Fail if any account failed, Ok if all accounts are registered
+	// and Unknown otherwise
 	virtual Registration registration() const = 0;
-	virtual std::vector<std::shared_ptr<Call>> calls() const = 0;
+
+	virtual Registration registration(InternedString const& aor) const = 0;
+
+	// all accounts seen so far, ordered by aor
+	virtual std::vector<Account> accounts() const = 0;
+
+	// Calls which are not closed, oldest first. The list is replaced
+	// on every change, so this and history() may be called from any
+	// thread while the model is updated.
+	virtual CallList calls() const = 0;
+
+	// the most recently closed calls, oldest first
+	virtual CallList history() const = 0;
 
 	virtual ~Model() = default;
 
 protected:
 	Slot<void(Event::Any const&)> on_event_;
 	Signal<void(std::shared_ptr<Call> const&)> on_call_;
+	Signal<void(Account const&)> on_registration_;
 };
 
 inline bool operator>(Call::Id const& l, Call::Id const& r)
@@ -129,3 +226,15 @@ inline bool operator!=(Call::Id const& l, Call::Id const& r)
 }
 
 }
+
+namespace std {
+
+template <>
+struct hash<Baresip::Call::Id> {
+	size_t operator()(Baresip::Call::Id const& id) const
+	{
+		return hash<string>{}(id.value_);
+	}
+};
+
+}
@@ -26,9 +26,12 @@
 #pragma once
 
 #include "flags.h"
+#include "histogram.h"
+#include "inline-function.h"
 
 #include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 
 namespace Posix {
@@ -50,23 +53,59 @@ using Events = Flags<Event>;
 
 class Ctrl {
 public:
-	virtual void add(std::shared_ptr<Posix::Fd> const&, Events const&, std::function<void(Events const&)> const&) = 0;
+	// Only collected by instrumented instances, all times in nanoseconds.
+	struct Stats {
+		Histogram wait;                      // time blocked in epoll_wait
+		Histogram dispatch;                  // time to dispatch all events of a wakeup
+		Histogram events;                    // events per wakeup
+		std::map<int, Histogram> handlers;   // time per callback invocation by fd
+	};
+
+	virtual void add(std::shared_ptr<Posix::Fd> const&, Events const&, InlineFunction<void(Events const&)>) = 0;
 	virtual void del(std::shared_ptr<Posix::Fd> const&) = 0;
 	virtual void mod(std::shared_ptr<Posix::Fd> const&, Events const&) const = 0;
 
+	// Run fn once after the events of the current (or, outside of a
+	// callback, the next) wait() are dispatched. Work deferred this
+	// way is batched per loop iteration, wait() does not block while
+	// any is pending.
+	virtual void defer(std::function<void()> const&) = 0;
+
+	// Queue fn to run on the thread calling wait(). Unlike all other
+	// members this may be called from any thread, it wakes up a
+	// blocking wait(). Queued functions run in order, after the events
+	// of the wakeup are dispatched. Functions still queued when the
+	// Ctrl is destroyed are dropped.
+	virtual void post(std::function<void()>) = 0;
+
 	static std::chrono::milliseconds Infinity();
 	virtual bool wait(std::chrono::milliseconds const& = Infinity()) const = 0;
 
+	virtual Stats stats() const = 0;
+	virtual void reset_stats() = 0;
+
 	virtual ~Ctrl() = default;
 };
 
 class CtrlFactory {
 public:
+	struct Params {
+		bool instrument = false;
+	};
+
 	static std::unique_ptr<CtrlFactory> create();
-	virtual std::unique_ptr<Ctrl> make_ctrl() const = 0;
+
+	std::unique_ptr<Ctrl> make_ctrl() const
+	{
+		return make_ctrl(Params{});
+	}
+
+	virtual std::unique_ptr<Ctrl> make_ctrl(Params const&) const = 0;
 	virtual ~CtrlFactory() = default;
 };
 
+std::string to_string(Ctrl::Stats const&);
+
 }
 
 DECLARE_FLAG_TYPE(EPoll::Event);
@@ -25,9 +25,10 @@
 */
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <type_traits>
-#include <initializer_list>
-#include <functional>
+#include <utility>
 
 template <typename T> struct IsFlagType;
 
@@ -55,6 +56,69 @@ public:
 		return value_ != 0;
 	}
 
+	// number of set flags
+	size_t count() const
+	{
+		return __builtin_popcountll(bits());
+	}
+
+	// Iterates the set flags in ascending order, skipping unset ones
+	// by counting trailing zeros.
+	class Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Flag;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Flag const*;
+		using reference = Flag;
+
+		explicit Iterator(unsigned long long bits)
+		:
+			bits_(bits)
+		{ }
+
+		Flag operator*() const
+		{
+			return Flag(__builtin_ctzll(bits_));
+		}
+
+		Iterator & operator++()
+		{
+			bits_ &= bits_ - 1;
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			auto res = *this;
+			++*this;
+			return res;
+		}
+
+		friend bool operator==(Iterator const& l, Iterator const& r)
+		{
+			return l.bits_ == r.bits_;
+		}
+
+		friend bool operator!=(Iterator const& l, Iterator const& r)
+		{
+			return l.bits_ != r.bits_;
+		}
+
+	private:
+		unsigned long long bits_;
+	};
+
+	Iterator begin() const
+	{
+		return Iterator(bits());
+	}
+
+	Iterator end() const
+	{
+		return Iterator(0);
+	}
+
 	Flags & operator=(Flag const& o)
 	{
 		return *this = Flags(o);
@@ -94,6 +158,11 @@ public:
 	}
 
 private:
+	unsigned long long bits() const
+	{
+		return static_cast<std::make_unsigned_t<decltype(value_)>>(value_);
+	}
+
 	std::underlying_type_t<Flag> value_ = 0;
 };
 
@@ -116,6 +185,12 @@ Flags<T> operator&(Flags<T> const& l, T const& r)
 	return l & Flags(r);
 }
 
+template <typename T>
+Flags<T> operator|(Flags<T> const& l, T const& r)
+{
+	return Flags<T>(l) |= r;
+}
+
 template <typename T>
 Flags<T> operator|(Flags<T> const& l, Flags<T> const& r)
 {
@@ -128,14 +203,26 @@ Flags<T> operator&(Flags<T> const& l, Flags<T> const& r)
 	return Flags<T>(l) &= r;
 }
 
-template <typename T>
-void dispatch(
-	Flags<T> const& flags,
-	std::initializer_list<std::tuple<T, std::function<void(void)>>> actions)
+template <typename T, typename Fn>
+struct FlagAction {
+	T flag;
+	Fn fn;
+};
+
+template <typename T, typename Fn>
+FlagAction<T, Fn> on_flag(T flag, Fn fn)
 {
-	for (auto const& action : actions) {
-		if (flags & std::get<0>(action)) {
-			std::get<1>(action)();
-		}
+	return FlagAction<T, Fn>{flag, std::move(fn)};
+}
+
+// Call the action of each flag set in flags, in ascending order of the
+// flags. Only the set bits are visited and the actions are called
+// directly, nothing is allocated.
+template <typename T, typename... Fns>
+void dispatch(Flags<T> const& flags, FlagAction<T, Fns> const& ...actions)
+{
+	auto mask = (Flags<T>(actions.flag) | ...);
+	for (auto flag : flags & mask) {
+		((flag == actions.flag ? actions.fn() : void()), ...);
 	}
 }
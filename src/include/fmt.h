@@ -25,52 +25,240 @@
 */
 #pragma once
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <sstream>
-#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
+/*
+   printf-like formatting where every conversion prints its argument
+   with operator<<, except %x which prints integers in hex with a 0x
+   prefix. %% is a literal %. Once all arguments are used up the rest of
+   the format string is copied verbatim.
+
+   Strings, characters and integers are written directly, only other
+   types go through a std::ostringstream.
+
+   Use FMT_FORMAT() with a string literal to have the number of
+   conversions checked against the number of arguments at compile time.
+*/
 namespace Fmt {
 
-template <typename... Args>
-std::string format(std::string const& fmt_str, Args ...args)
+// number of conversions in a format string
+constexpr size_t placeholders(std::string_view fmt)
 {
-	auto stringer = std::initializer_list<std::function<void(std::ostream &, int)>>{
-		[&args]() { return [&args](std::ostream & os, int c) {
-			switch (c) {
-			case 'x':
-				os << "0x" << std::hex << args << std::dec;
-				break;
-			default:
-				os << args;
-			}
-		}; }()...
-	};
-
-	auto do_fmt{false};
-	auto to_string(std::begin(stringer));
-	std::stringstream ss;
-	for (auto c : fmt_str) {
-		if (to_string == std::end(stringer)) {
-			ss << c;
+	size_t res{0};
+	for (size_t i{0}; i + 1 < fmt.size(); ++i) {
+		if (fmt[i] != '%') {
 			continue;
 		}
+		if (fmt[i + 1] != '%') {
+			++res;
+		}
+		++i;
+	}
+	return res;
+}
 
-		if (c == '%') {
-			if (std::exchange(do_fmt, !do_fmt)) {
-				ss << c;
-			}
-			continue;
+template <size_t Placeholders, size_t Args>
+constexpr void check()
+{
+	static_assert(Placeholders == Args, "number of format conversions does not match the number of arguments");
+}
+
+// only for counting arguments in unevaluated context
+template <typename... Args>
+std::integral_constant<size_t, sizeof...(Args)> arity(Args const& ...);
+
+namespace Detail {
+
+class StringOut {
+public:
+	explicit StringOut(std::string & str)
+	:
+		str_(str)
+	{ }
+
+	void put(char c)
+	{
+		str_.push_back(c);
+	}
+
+	void append(std::string_view s)
+	{
+		str_.append(s);
+	}
+
+private:
+	std::string & str_;
+};
+
+// writes up to size chars but counts all of them
+class BufferOut {
+public:
+	BufferOut(char *buf, size_t size)
+	:
+		buf_(buf),
+		size_(size)
+	{ }
+
+	void put(char c)
+	{
+		if (len_ < size_) {
+			buf_[len_] = c;
+		}
+		++len_;
+	}
+
+	void append(std::string_view s)
+	{
+		if (len_ < size_) {
+			std::memcpy(buf_ + len_, s.data(), std::min(s.size(), size_ - len_));
+		}
+		len_ += s.size();
+	}
+
+	size_t size() const
+	{
+		return len_;
+	}
+
+private:
+	char *buf_;
+	size_t size_;
+	size_t len_ = 0;
+};
+
+template <typename T>
+constexpr bool is_char_v =
+	std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+template <typename Out, typename T>
+void write_integer(Out & out, T value, int base)
+{
+	char buf[2 + 64];
+	auto res = std::to_chars(buf, buf + sizeof(buf), value, base);
+	out.append(std::string_view(buf, res.ptr - buf));
+}
+
+template <typename Out, typename T>
+void write_arg(Out & out, char spec, T const& arg)
+{
+	if constexpr (std::is_same_v<T, bool>) {
+		out.put(arg ? '1' : '0');
+	} else if constexpr (is_char_v<T>) {
+		if (spec == 'x') {
+			out.append("0x");
+			write_integer(out, unsigned(static_cast<unsigned char>(arg)), 16);
+		} else {
+			out.put(char(arg));
+		}
+	} else if constexpr (std::is_integral_v<T>) {
+		if (spec == 'x') {
+			out.append("0x");
+			write_integer(out, std::make_unsigned_t<T>(arg), 16);
+		} else {
+			write_integer(out, arg, 10);
+		}
+	} else if constexpr (std::is_same_v<T, char const*> || std::is_same_v<T, char *>) {
+		out.append(arg ? std::string_view(arg) : std::string_view("(null)"));
+	} else if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+		out.append(std::string_view(arg));
+	} else {
+		std::ostringstream os;
+		if (spec == 'x') {
+			os << "0x" << std::hex;
+		}
+		os << arg;
+		out.append(os.str());
+	}
+}
+
+template <typename Out, typename... Args>
+void write_nth(Out & out, size_t n, char spec, Args const& ...args)
+{
+	size_t i{0};
+	((i++ == n ? write_arg(out, spec, args) : void()), ...);
+}
+
+// Copy fmt to out, writing the count arguments through
+// write(out, index, spec) in order.
+template <typename Out, typename Write>
+void format_with(Out & out, std::string_view fmt, size_t count, Write && write)
+{
+	size_t pos{0};
+	size_t next{0};
+	while (next < count) {
+		auto pct = fmt.find('%', pos);
+		if (pct == std::string_view::npos) {
+			break;
+		}
+
+		out.append(fmt.substr(pos, pct - pos));
+		pos = pct + 2;
+		if (pct + 1 == fmt.size()) {
+			// a trailing % is dropped
+			break;
 		}
 
-		if (std::exchange(do_fmt, false)) {
-			(*to_string++)(ss, c);
+		auto spec = fmt[pct + 1];
+		if (spec == '%') {
+			out.put('%');
 			continue;
 		}
+		write(out, next++, spec);
+	}
+
+	if (pos < fmt.size()) {
+		out.append(fmt.substr(pos));
+	}
+}
 
-		ss << c;
+template <typename Out, typename... Args>
+void format(Out & out, std::string_view fmt, Args const& ...args)
+{
+	if constexpr (sizeof...(Args) == 0) {
+		out.append(fmt);
+	} else {
+		format_with(out, fmt, sizeof...(Args), [&args...] (Out & o, size_t n, char spec) {
+			write_nth(o, n, spec, args...);
+		});
 	}
+}
+
+}
 
-	return ss.str();
+template <typename... Args>
+std::string format(std::string_view fmt, Args const& ...args)
+{
+	auto res = std::string{};
+	res.reserve(fmt.size() + 16 * sizeof...(Args));
+	auto out = Detail::StringOut{res};
+	Detail::format(out, fmt, args...);
+	return res;
+}
+
+// Format into buf without allocating for strings, characters and
+// integers. Like snprintf() this returns the length of the complete
+// output, at most size chars are written and no terminating NUL.
+template <typename... Args>
+size_t format_to(char *buf, size_t size, std::string_view fmt, Args const& ...args)
+{
+	auto out = Detail::BufferOut{buf, size};
+	Detail::format(out, fmt, args...);
+	return out.size();
 }
 
 }
+
+#define FMT_CHECK(fmt, ...) \
+	Fmt::check<Fmt::placeholders(fmt), decltype(Fmt::arity(__VA_ARGS__))::value>()
+
+// Fmt::format() with the format string checked at compile time, fmt
+// must be a string literal and at least one argument is required
+#define FMT_FORMAT(fmt, ...) \
+	(FMT_CHECK(fmt, __VA_ARGS__), Fmt::format((fmt), __VA_ARGS__))
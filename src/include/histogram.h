@@ -0,0 +1,111 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+/*
+   Log-linear histogram in the spirit of HdrHistogram.
+
+   Values below 2 * SubBuckets are counted exactly, larger values are
+   grouped by their most significant bit into SubBuckets linear
+   sub-buckets each, which bounds the relative error to 1/SubBuckets.
+   Recording never allocates.
+*/
+class Histogram {
+public:
+	static constexpr size_t SubBucketBits = 4;
+	static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+	static constexpr size_t Buckets = (64 - SubBucketBits + 1) * SubBuckets;
+
+	void record(uint64_t value)
+	{
+		++counts_[index(value)];
+		++count_;
+		sum_ += value;
+		if (value < min_) {
+			min_ = value;
+		}
+		if (value > max_) {
+			max_ = value;
+		}
+	}
+
+	void reset()
+	{
+		*this = Histogram{};
+	}
+
+	uint64_t count() const
+	{
+		return count_;
+	}
+
+	uint64_t min() const
+	{
+		return count_ ? min_ : 0;
+	}
+
+	uint64_t max() const
+	{
+		return max_;
+	}
+
+	double mean() const
+	{
+		return count_ ? double(sum_) / count_ : 0.0;
+	}
+
+	// highest value equivalent to the sample at the given
+	// percentile (0.0 - 100.0)
+	uint64_t percentile(double) const;
+
+	Histogram & operator+=(Histogram const&);
+
+	static size_t index(uint64_t value)
+	{
+		if (value < 2 * SubBuckets) {
+			return value;
+		}
+
+		size_t shift = 63 - __builtin_clzll(value) - SubBucketBits;
+		return (shift + 1) * SubBuckets + ((value >> shift) - SubBuckets);
+	}
+
+	static uint64_t highest_equivalent(size_t);
+
+private:
+	std::array<uint64_t, Buckets> counts_ = {};
+	uint64_t count_ = 0;
+	uint64_t sum_ = 0;
+	uint64_t min_ = std::numeric_limits<uint64_t>::max();
+	uint64_t max_ = 0;
+};
+
+std::string to_string(Histogram const&);
@@ -0,0 +1,177 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+   Move-only replacement for std::function which stores the callable
+   inline and never allocates. Callables larger than Size bytes are
+   rejected at compile time, capture a pointer to the state instead.
+*/
+template <typename Sig, size_t Size = 6 * sizeof(void *)>
+class InlineFunction;
+
+template <typename R, typename... Args, size_t Size>
+class InlineFunction<R(Args...), Size> {
+public:
+	InlineFunction() = default;
+
+	InlineFunction(std::nullptr_t)
+	{ }
+
+	template <typename F, typename = std::enable_if_t<
+		!std::is_same_v<std::decay_t<F>, InlineFunction> &&
+		std::is_invocable_r_v<R, std::decay_t<F> &, Args...>>>
+	InlineFunction(F && f)
+	{
+		using Fn = std::decay_t<F>;
+		static_assert(sizeof(Fn) <= Size, "callable does not fit into InlineFunction");
+		static_assert(alignof(Fn) <= alignof(std::max_align_t), "callable is overaligned");
+		static_assert(std::is_nothrow_move_constructible_v<Fn>, "callable must be nothrow movable");
+
+		if (is_null(f)) {
+			return;
+		}
+		new (&storage_) Fn(std::forward<F>(f));
+		ops_ = &OpsFor<Fn>::ops;
+	}
+
+	InlineFunction(InlineFunction && o) noexcept
+	{
+		move_from(o);
+	}
+
+	InlineFunction & operator=(InlineFunction && o) noexcept
+	{
+		if (&o != this) {
+			reset();
+			move_from(o);
+		}
+		return *this;
+	}
+
+	InlineFunction & operator=(std::nullptr_t)
+	{
+		reset();
+		return *this;
+	}
+
+	InlineFunction(InlineFunction const&) = delete;
+	InlineFunction & operator=(InlineFunction const&) = delete;
+
+	~InlineFunction()
+	{
+		reset();
+	}
+
+	explicit operator bool() const
+	{
+		return ops_ != nullptr;
+	}
+
+	R operator()(Args... args) const
+	{
+		if (!ops_) {
+			throw std::bad_function_call();
+		}
+		return ops_->invoke(&storage_, std::forward<Args>(args)...);
+	}
+
+private:
+	struct Ops {
+		R (*invoke)(void *, Args && ...);
+		// move construct into uninitialized storage and destroy the source
+		void (*relocate)(void *, void *);
+		void (*destroy)(void *);
+	};
+
+	template <typename Fn>
+	struct OpsFor {
+		static R invoke(void *fn, Args && ...args)
+		{
+			return std::invoke(*static_cast<Fn *>(fn), std::forward<Args>(args)...);
+		}
+
+		static void relocate(void *dst, void *src)
+		{
+			new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+			static_cast<Fn *>(src)->~Fn();
+		}
+
+		static void destroy(void *fn)
+		{
+			static_cast<Fn *>(fn)->~Fn();
+		}
+
+		static constexpr Ops ops{&invoke, &relocate, &destroy};
+	};
+
+	template <typename F>
+	static bool is_null(F const& f)
+	{
+		if constexpr (std::is_pointer_v<F> || std::is_member_pointer_v<F>) {
+			return f == nullptr;
+		} else {
+			return is_empty_function(f);
+		}
+	}
+
+	template <typename F>
+	static bool is_empty_function(F const&)
+	{
+		return false;
+	}
+
+	template <typename S>
+	static bool is_empty_function(std::function<S> const& f)
+	{
+		return !f;
+	}
+
+	void move_from(InlineFunction & o)
+	{
+		if (o.ops_) {
+			o.ops_->relocate(&storage_, &o.storage_);
+			ops_ = std::exchange(o.ops_, nullptr);
+		}
+	}
+
+	void reset()
+	{
+		if (ops_) {
+			std::exchange(ops_, nullptr)->destroy(&storage_);
+		}
+	}
+
+	// mutable as the callable itself may be mutable
+	alignas(std::max_align_t) mutable unsigned char storage_[Size];
+	Ops const* ops_ = nullptr;
+};
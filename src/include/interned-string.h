@@ -0,0 +1,120 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Handle to a string stored once per process.
+//
+// Interning the same text twice yields handles to the same storage, so
+// handles compare equal and hash by pointer. The storage is never
+// freed, only use this for strings from a bounded set like account
+// AORs. Interning is thread safe, handles are immutable.
+class InternedString {
+public:
+	InternedString();
+
+	InternedString(std::string_view const&);
+
+	InternedString(std::string const& str)
+	:
+		InternedString(std::string_view{str})
+	{ }
+
+	InternedString(char const* str)
+	:
+		InternedString(std::string_view{str})
+	{ }
+
+	std::string_view view() const
+	{
+		return *str_;
+	}
+
+	std::string const& str() const
+	{
+		return *str_;
+	}
+
+	bool empty() const
+	{
+		return str_->empty();
+	}
+
+	// number of distinct strings interned so far
+	static size_t pool_size();
+
+private:
+	friend bool operator==(InternedString const& l, InternedString const& r)
+	{
+		return l.str_ == r.str_;
+	}
+
+	// lexicographic, so the order does not depend on interning order
+	friend bool operator<(InternedString const& l, InternedString const& r)
+	{
+		return l.str_ != r.str_ && *l.str_ < *r.str_;
+	}
+
+	friend struct std::hash<InternedString>;
+
+	std::string const* str_;
+};
+
+inline bool operator!=(InternedString const& l, InternedString const& r)
+{
+	return !(l == r);
+}
+
+inline bool operator>(InternedString const& l, InternedString const& r)
+{
+	return r < l;
+}
+
+inline std::string to_string(InternedString const& str)
+{
+	return str.str();
+}
+
+inline std::ostream & operator<<(std::ostream & os, InternedString const& str)
+{
+	return os << str.view();
+}
+
+namespace std {
+
+template <>
+struct hash<InternedString> {
+	size_t operator()(InternedString const& str) const
+	{
+		return hash<std::string const*>{}(str.str_);
+	}
+};
+
+}
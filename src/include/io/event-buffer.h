@@ -26,19 +26,18 @@
 #pragma once
 
 #include <io/buffer.h>
-
-#include <functional>
+#include <inline-function.h>
 
 namespace IO {
 
 class ReadEventBuffer : public IO::ReadBuffer {
 public:
-	virtual void on_fill(std::function<void(void)> const&) = 0;
+	virtual void on_fill(InlineFunction<void(void)>) = 0;
 };
 
 class WriteEventBuffer : public IO::WriteBuffer {
 public:
-	virtual void on_drain(std::function<void(void)> const&) = 0;
+	virtual void on_drain(InlineFunction<void(void)>) = 0;
 };
 
 class EventBuffer : public ReadEventBuffer, public WriteEventBuffer {
@@ -68,7 +67,9 @@ public:
 	void drain(size_t size) final
 	{
 		buf_.drain(size);
-		on_drain_();
+		if (on_drain_) {
+			on_drain_();
+		}
 	}
 
 	void *wstart() const final
@@ -94,23 +95,25 @@ public:
 	void fill(size_t size) final
 	{
 		buf_.fill(size);
-		on_fill_();
+		if (on_fill_) {
+			on_fill_();
+		}
 	}
 
-	void on_fill(std::function<void(void)> const& cb) final
+	void on_fill(InlineFunction<void(void)> cb) final
 	{
-		on_fill_ = cb;
+		on_fill_ = std::move(cb);
 	}
 
-	void on_drain(std::function<void(void)> const& cb) final
+	void on_drain(InlineFunction<void(void)> cb) final
 	{
-		on_drain_ = cb;
+		on_drain_ = std::move(cb);
 	}
 
 private:
 	IO::Buffer buf_;
-	std::function<void(void)> on_drain_;
-	std::function<void(void)> on_fill_;
+	InlineFunction<void(void)> on_drain_;
+	InlineFunction<void(void)> on_fill_;
 };
 
 }
@@ -26,24 +26,87 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <utility>
+#include <vector>
 #include "fmt.h"
+#include "log/args.h"
+
+// Messages below this level are compiled out by the LOG_* macros,
+// 0 (Debug) to 3 (Error).
+#ifndef CLINGELING_LOG_LEVEL
+#define CLINGELING_LOG_LEVEL 0
+#endif
 
 namespace Log {
 
+enum class Level : uint8_t {
+	Debug,
+	Info,
+	Warning,
+	Error,
+};
+
+constexpr Level MinLevel = Level(CLINGELING_LOG_LEVEL);
+
+std::string to_string(Level);
+
+// Either formatted text or a deferred message, which keeps the format
+// string and a copy of the arguments and is formatted by get_msg().
 class Message {
 public:
-	explicit Message(std::string const& msg)
+	explicit Message(std::string msg, Level level = Level::Info)
 	:
-		msg_(msg)
+		level_(level),
+		msg_(std::move(msg))
 	{ }
 
+	// fmt must outlive the message, use a string literal
+	template <typename... T>
+	static Message deferred(Level level, char const* fmt, T const& ...args)
+	{
+		return Message(level, fmt, Args(args...));
+	}
+
+	Level level() const
+	{
+		return level_;
+	}
+
+	// format string of a deferred message, nullptr otherwise
+	char const* format() const
+	{
+		return fmt_;
+	}
+
+	Args const& args() const
+	{
+		return args_;
+	}
+
 	std::string get_msg() const
 	{
-		return msg_;
+		if (!fmt_) {
+			return msg_;
+		}
+
+		auto res = std::string{};
+		args_.format(res, fmt_);
+		return res;
 	}
 
 private:
+	Message(Level level, char const* fmt, Args const& args)
+	:
+		level_(level),
+		fmt_(fmt),
+		args_(args)
+	{ }
+
+	Level level_;
+	char const* fmt_ = nullptr;
 	std::string msg_;
+	Args args_;
 };
 
 template <typename... Args>
@@ -72,4 +135,18 @@ private:
 
 }
 
-
+// Post a deferred message to logger (a Logger or an AsyncLogger), the
+// arguments are only copied and formatted when a sink asks for the
+// text. fmt must be a string literal and is checked at compile time.
+#define LOG_AT(logger, level, fmt, ...) \
+	do { \
+		if constexpr ((level) >= Log::MinLevel) { \
+			FMT_CHECK(fmt, ##__VA_ARGS__); \
+			(logger).post(Log::Message::deferred((level), (fmt), ##__VA_ARGS__)); \
+		} \
+	} while (0)
+
+#define LOG_DEBUG(logger, fmt, ...) LOG_AT(logger, Log::Level::Debug, fmt, ##__VA_ARGS__)
+#define LOG_INFO(logger, fmt, ...) LOG_AT(logger, Log::Level::Info, fmt, ##__VA_ARGS__)
+#define LOG_WARNING(logger, fmt, ...) LOG_AT(logger, Log::Level::Warning, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(logger, fmt, ...) LOG_AT(logger, Log::Level::Error, fmt, ##__VA_ARGS__)
@@ -0,0 +1,155 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Log {
+
+/*
+   Arguments of a log message in a compact binary form, to be formatted
+   only when the message is read.
+
+   Only values which can be copied as bytes are supported: booleans,
+   characters, integers, floating point numbers and strings. Anything
+   else has to be formatted by the caller. Arguments not fitting into
+   Capacity bytes are dropped along with all following ones, strings
+   are cut to fit.
+*/
+class Args {
+public:
+	static constexpr size_t Capacity = 112;
+
+	// each argument is stored as its tag followed by its value,
+	// strings are prefixed with their size in one byte
+	enum class Tag : uint8_t {
+		Bool,
+		Char,
+		Int64,
+		UInt64,
+		Double,
+		String,
+		// integers keep their width, "%x" of a negative value
+		// depends on it
+		Int16,
+		Int32,
+		UInt16,
+		UInt32,
+	};
+
+	Args() = default;
+
+	template <typename... T>
+	explicit Args(T const& ...args)
+	{
+		(put(args), ...);
+	}
+
+	// restore arguments from bytes(), throws std::runtime_error if
+	// they are invalid
+	static Args from_bytes(std::string_view);
+
+	std::string_view bytes() const
+	{
+		return std::string_view(data_, size_);
+	}
+
+	size_t count() const
+	{
+		return count_;
+	}
+
+	// format like Fmt::format() with the stored arguments
+	void format(std::string &, std::string_view fmt) const;
+
+private:
+	template <typename T>
+	void put(T const& arg)
+	{
+		if constexpr (std::is_same_v<T, bool>) {
+			put_value(Tag::Bool, uint8_t(arg));
+		} else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+			put_value(Tag::Char, char(arg));
+		} else if constexpr (std::is_integral_v<T>) {
+			put_integer(arg);
+		} else if constexpr (std::is_floating_point_v<T>) {
+			put_value(Tag::Double, double(arg));
+		} else if constexpr (std::is_same_v<T, char const*> || std::is_same_v<T, char *>) {
+			put_string(arg ? std::string_view(arg) : std::string_view("(null)"));
+		} else if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+			put_string(std::string_view(arg));
+		} else {
+			static_assert(std::is_void_v<T>, "type can't be stored as log argument, format it first");
+		}
+	}
+
+	template <typename T>
+	void put_integer(T arg)
+	{
+		if constexpr (std::is_signed_v<T> && sizeof(T) <= 2) {
+			put_value(Tag::Int16, int16_t(arg));
+		} else if constexpr (std::is_signed_v<T> && sizeof(T) <= 4) {
+			put_value(Tag::Int32, int32_t(arg));
+		} else if constexpr (std::is_signed_v<T>) {
+			put_value(Tag::Int64, int64_t(arg));
+		} else if constexpr (sizeof(T) <= 2) {
+			put_value(Tag::UInt16, uint16_t(arg));
+		} else if constexpr (sizeof(T) <= 4) {
+			put_value(Tag::UInt32, uint32_t(arg));
+		} else {
+			put_value(Tag::UInt64, uint64_t(arg));
+		}
+	}
+
+	template <typename V>
+	void put_value(Tag tag, V value)
+	{
+		if (full_ || size_ + 1 + sizeof(value) > Capacity) {
+			full_ = true;
+			return;
+		}
+
+		data_[size_++] = char(tag);
+		std::memcpy(data_ + size_, &value, sizeof(value));
+		size_ += sizeof(value);
+		++count_;
+	}
+
+	void put_string(std::string_view);
+
+	uint8_t size_ = 0;
+	uint8_t count_ = 0;
+	// set once an argument was dropped, later ones would end up in the
+	// wrong placeholders
+	bool full_ = false;
+	char data_[Capacity];
+};
+
+}
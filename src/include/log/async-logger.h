@@ -0,0 +1,86 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "log.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Log {
+
+/*
+   Hands messages to a Logger on a background thread.
+
+   Every thread posting messages gets its own single producer ring, so
+   post() takes no lock and never waits for a sink. The sinks of the
+   Logger are called on the writer thread only, they must all be
+   registered before the AsyncLogger is created.
+*/
+class AsyncLogger {
+public:
+	enum class Policy {
+		// a message posted to a full ring is dropped and counted
+		Drop,
+		// post() waits for the writer to make room
+		Block,
+	};
+
+	struct Params {
+		// messages per posting thread
+		size_t capacity = 1024;
+		Policy policy = Policy::Drop;
+	};
+
+	struct Stats {
+		uint64_t posted = 0;
+		uint64_t dropped = 0;
+		uint64_t written = 0;
+	};
+
+	static std::unique_ptr<AsyncLogger> create(Logger const&, Params const&);
+
+	static std::unique_ptr<AsyncLogger> create(Logger const& logger)
+	{
+		return create(logger, Params{});
+	}
+
+	// may be called from any thread
+	virtual void post(Message &&) = 0;
+
+	// wait until all messages posted so far are written
+	virtual void flush() = 0;
+
+	virtual Stats stats() const = 0;
+
+	// remaining messages are written before the writer thread exits
+	virtual ~AsyncLogger() = default;
+};
+
+std::string to_string(AsyncLogger::Stats const&);
+
+}
@@ -0,0 +1,111 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "log.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Posix {
+class Fd;
+}
+
+namespace Log {
+namespace Binary {
+
+/*
+   Binary log file which keeps deferred messages unformatted.
+
+   A file starts with Magic followed by records. Each record is the
+   varint encoded size of its payload and the payload, which starts
+   with the record type. A format record holds the text of a format
+   string, which gets the next format id. A deferred record holds the
+   level, the varint format id and the bytes of the arguments. A text
+   record holds the level and an already formatted message. Each
+   format string is written once per file, before its first use.
+
+   The Writer collects records in memory and writes them once
+   Params::buffer_size is reached, on flush() and when it is destroyed,
+   so logging a message costs no system call. It writes from the thread
+   calling write(), put it behind an AsyncLogger to keep file I/O out of
+   the event loop.
+*/
+
+constexpr std::string_view Magic{"CLL1"};
+
+class Writer {
+public:
+	struct Params {
+		size_t buffer_size = 64 * 1024;
+	};
+
+	// writes Magic to fd
+	explicit Writer(std::shared_ptr<Posix::Fd> const&);
+	Writer(std::shared_ptr<Posix::Fd> const&, Params const&);
+
+	Writer(Writer const&) = delete;
+	Writer & operator=(Writer const&) = delete;
+
+	// flushes, errors are ignored
+	~Writer();
+
+	void write(Message const&);
+
+	// write all buffered records
+	void flush();
+
+private:
+	void add_record();
+
+	std::shared_ptr<Posix::Fd> fd_;
+	Params params_;
+	// format ids by address of the format string
+	std::unordered_map<char const*, uint64_t> formats_;
+	// reused for every record
+	std::string payload_;
+	// records not written yet
+	std::string buf_;
+};
+
+class Reader {
+public:
+	// throws std::runtime_error if data doesn't start with Magic
+	explicit Reader(std::string_view const&);
+
+	// Formats the next message. Returns false at the end of the data,
+	// throws std::runtime_error if a record is truncated or invalid.
+	bool next(Level &, std::string &);
+
+private:
+	std::string_view data_;
+	std::vector<std::string> formats_;
+};
+
+}}
@@ -0,0 +1,213 @@
+/*
+   Copyright (c) 2023 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Netlink {
+
+class UEventFilter;
+
+/*
+   View of a NETLINK_KOBJECT_UEVENT datagram, parsed in place.
+
+   Two formats are understood: the kernel's "ACTION@DEVPATH" header
+   (multicast group 1) and the "libudev" header udevd sends once it
+   has processed an event (group 2). Both are followed by NUL separated
+   KEY=VALUE properties. Nothing is copied, the event refers to the
+   datagram, which has to outlive it.
+*/
+class UEvent {
+public:
+	enum class Source {
+		Kernel,
+		Udev,
+	};
+
+	using Property = std::pair<std::string_view, std::string_view>;
+
+	class Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Property;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Property const*;
+		using reference = Property const&;
+
+		Iterator() = default;
+
+		explicit Iterator(std::string_view rest)
+		:
+			rest_(rest)
+		{
+			next();
+		}
+
+		reference operator*() const
+		{
+			return prop_;
+		}
+
+		pointer operator->() const
+		{
+			return &prop_;
+		}
+
+		Iterator & operator++()
+		{
+			next();
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			auto res = *this;
+			next();
+			return res;
+		}
+
+		bool operator==(Iterator const& o) const
+		{
+			return end_ == o.end_ && (end_ || rest_.data() == o.rest_.data());
+		}
+
+		bool operator!=(Iterator const& o) const
+		{
+			return !(*this == o);
+		}
+
+	private:
+		void next();
+
+		std::string_view rest_;
+		Property prop_;
+		bool end_ = true;
+	};
+
+	// std::nullopt if the datagram is malformed
+	static std::optional<UEvent> parse(std::string_view);
+
+	// std::nullopt if the datagram is malformed or does not pass the
+	// filter, udevd messages are checked against the subsystem and
+	// devtype hashes in their header before the properties are read
+	static std::optional<UEvent> parse(std::string_view, UEventFilter const&);
+
+	Source source() const
+	{
+		return source_;
+	}
+
+	std::string_view action() const
+	{
+		return action_;
+	}
+
+	std::string_view devpath() const
+	{
+		return devpath_;
+	}
+
+	std::string_view subsystem() const
+	{
+		return subsystem_;
+	}
+
+	std::string_view devtype() const
+	{
+		return devtype_;
+	}
+
+	uint64_t seqnum() const
+	{
+		return seqnum_;
+	}
+
+	// empty if the property is missing, walks all properties
+	std::string_view get(std::string_view key) const;
+
+	Iterator begin() const
+	{
+		return Iterator{properties_};
+	}
+
+	Iterator end() const
+	{
+		return Iterator{};
+	}
+
+private:
+	UEvent() = default;
+
+	static std::optional<UEvent> parse_properties(Source, std::string_view);
+
+	Source source_ = Source::Kernel;
+	std::string_view properties_;
+	std::string_view action_;
+	std::string_view devpath_;
+	std::string_view subsystem_;
+	std::string_view devtype_;
+	uint64_t seqnum_ = 0;
+};
+
+// Subsystem/devtype matches as in udev_monitor_filter_add_match_subsystem_devtype(),
+// an event passes if it matches any of them or no match was added.
+class UEventFilter {
+public:
+	// an empty devtype matches all devtypes of the subsystem
+	void add_match_subsystem_devtype(std::string_view subsystem, std::string_view devtype = {});
+
+	bool empty() const
+	{
+		return matches_.empty();
+	}
+
+	bool match(std::string_view subsystem, std::string_view devtype) const;
+
+	// false only if no match can apply, hash collisions pass
+	bool match_hashes(uint32_t subsystem_hash, uint32_t devtype_hash) const;
+
+	// MurmurHash2 as used by libudev for its header filter fields
+	static uint32_t hash(std::string_view);
+
+private:
+	struct Match {
+		std::string subsystem;
+		std::string devtype;
+		uint32_t subsystem_hash;
+		uint32_t devtype_hash;
+	};
+
+	std::vector<Match> matches_;
+};
+
+}
@@ -38,6 +38,10 @@ public:
 	explicit Reader(IO::StreamBuffer &);
 	bool parse(std::string &);
 
+	// forget a partially parsed netstring, the caller is responsible
+	// for discarding its data from the buffer
+	void reset();
+
 private:
 	enum class State {
 		start,
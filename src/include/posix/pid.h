@@ -26,9 +26,12 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Posix {
 
+class Fd;
 enum class Signal;
 
 namespace Wait {
@@ -39,9 +42,18 @@ enum class Option;
 class Pid {
 public:
 	static std::shared_ptr<Pid> create(int);
+
+	// posix_spawnp(3) argv[0] with the given arguments, the child
+	// starts with an empty signal mask and default signal dispositions
+	static std::shared_ptr<Pid> spawn(std::vector<std::string> const& argv);
+
+	virtual int get() const = 0;
 	virtual void kill(Signal) = 0;
 	virtual Wait::Status wait(Wait::Option) = 0;
 
+	// pidfd_open(2) file descriptor, readable once the process exited
+	virtual std::shared_ptr<Fd> fd() = 0;
+
 	virtual ~Pid() = default;
 };
 
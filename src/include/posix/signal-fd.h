@@ -0,0 +1,62 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <posix/fd.h>
+
+#include <vector>
+
+namespace Posix {
+
+enum class Signal;
+
+class SignalInfo {
+public:
+	Signal signo;
+	int code = 0;
+	int pid = 0;
+	int uid = 0;
+	int status = 0;
+};
+
+class SignalFd : public Fd {
+public:
+	// Read at most the given number of pending signals with a single
+	// read(2). Returns the number of signals read, 0 if none are pending.
+	virtual size_t read_signals(SignalInfo *, size_t) const = 0;
+};
+
+class SignalFdFactory {
+public:
+	static std::unique_ptr<SignalFdFactory> create();
+
+	// The signals are blocked for the calling thread as long as the
+	// SignalFd exists.
+	virtual std::shared_ptr<SignalFd> make_signalfd(std::vector<Signal> const&, Fd::Options const&) const = 0;
+	virtual ~SignalFdFactory() = default;
+};
+
+}
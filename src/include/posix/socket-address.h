@@ -26,6 +26,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 struct sockaddr;
 struct sockaddr_in;
@@ -38,12 +39,17 @@ namespace Inet {
 class Address;
 }
 
+namespace Unix {
+class Address;
+}
+
 class SocketAddress {
 public:
 	SocketAddress();
 
 	SocketAddress(std::unique_ptr<sockaddr_storage>, size_t);
 	SocketAddress(Inet::Address const&, uint16_t);
+	explicit SocketAddress(Unix::Address const&);
 	SocketAddress(SocketAddress const&);
 	SocketAddress(SocketAddress &&);
 	SocketAddress & operator=(SocketAddress const&);
@@ -65,6 +71,9 @@ public:
 		return size_ != 0;
 	}
 
+	// AF_INET, AF_INET6, AF_UNIX or AF_UNSPEC for an empty address
+	int family() const;
+
 	friend bool operator<(SocketAddress const&, SocketAddress const&);
 	friend std::string to_string(SocketAddress const&);
 
@@ -120,4 +129,8 @@ inline bool operator>=(SocketAddress const& l, SocketAddress const& r)
 
 std::string to_string(SocketAddress const&);
 
+// Parse "host:port", "[v6 host]:port", a unix socket path or an
+// abstract unix socket name starting with '@'
+SocketAddress parse_socket_address(std::string const&);
+
 }
@@ -38,8 +38,14 @@ class Socket : public Fd {
 public:
 	virtual void bind(SocketAddress const&) const = 0;
 	virtual void connect(SocketAddress const&) const = 0;
+	virtual void listen(int) const = 0;
+	// throws a std::system_error with EAGAIN if a nonblocking socket
+	// has no pending connection
+	virtual std::shared_ptr<Socket> accept(Fd::Options const&) const = 0;
 	virtual std::error_code get_socket_error() const = 0;
 	virtual void set_recvbuf(size_t) const = 0;
+	// TCP_NODELAY, send small writes without waiting for outstanding acks
+	virtual void set_nodelay(bool) const = 0;
 
 	virtual ~Socket() = default;
 };
@@ -38,17 +38,21 @@ inline std::system_error make_system_error(int ev, std::string const& what_arg)
 }
 
 template <typename... Args>
-std::system_error make_system_error(int ev, std::string const& fmt, Args ...args)
+std::system_error make_system_error(int ev, std::string_view fmt, Args const& ...args)
 {
 	return make_system_error(ev, Fmt::format(fmt, args...));
 }
 
 template <typename... Args>
-std::system_error make_system_error_detail(int ev, SourceLocation const& sl, std::string const& fmt, Args ...args)
+std::system_error make_system_error_detail(int ev, SourceLocation const& sl, std::string_view fmt, Args const& ...args)
 {
-	return make_system_error(ev, Fmt::format(std::string("%s: ") + fmt, to_string(sl), args...));
+	return make_system_error(ev, to_string(sl) + ": " + Fmt::format(fmt, args...));
 }
 
 }
 
-#define POSIX_SYSTEM_ERROR(fmt, ...) Posix::make_system_error_detail(errno, SourceLocation::current(), (fmt), __VA_ARGS__)
+// fmt must be a string literal, it is checked against the arguments
+// at compile time
+#define POSIX_SYSTEM_ERROR(fmt, ...) \
+	(FMT_CHECK(fmt, __VA_ARGS__), \
+	Posix::make_system_error_detail(errno, SourceLocation::current(), (fmt), __VA_ARGS__))
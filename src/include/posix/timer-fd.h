@@ -0,0 +1,53 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <posix/fd.h>
+
+#include <chrono>
+
+namespace Posix {
+
+// CLOCK_MONOTONIC timerfd
+class TimerFd : public Fd {
+public:
+	// arm the timer to expire after the given time and then every
+	// interval, an interval of zero makes it a one-shot timer
+	virtual void set(std::chrono::nanoseconds const&, std::chrono::nanoseconds const& = {}) const = 0;
+	virtual void cancel() const = 0;
+
+	// number of expirations since the last call, 0 if none
+	virtual uint64_t expirations() const = 0;
+};
+
+class TimerFdFactory {
+public:
+	static std::unique_ptr<TimerFdFactory> create();
+	virtual std::shared_ptr<TimerFd> make_timerfd(Fd::Options const&) const = 0;
+	virtual ~TimerFdFactory() = default;
+};
+
+}
@@ -0,0 +1,88 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <string>
+
+namespace Posix {
+namespace Unix {
+
+// Path of an AF_UNIX socket, a leading '@' denotes a name in the
+// Linux abstract namespace which does not exist in the file system.
+class Address {
+public:
+	Address() = default;
+
+	explicit Address(std::string const& path)
+	:
+		path_(path)
+	{ }
+
+	explicit operator bool() const
+	{
+		return !path_.empty();
+	}
+
+	bool abstract() const
+	{
+		return !path_.empty() && path_[0] == '@';
+	}
+
+	std::string const& path() const
+	{
+		return path_;
+	}
+
+	friend bool operator<(Address const& l, Address const& r)
+	{
+		return l.path_ < r.path_;
+	}
+
+private:
+	std::string path_;
+};
+
+inline bool operator>(Address const& l, Address const& r)
+{
+	return r < l;
+}
+
+inline bool operator==(Address const& l, Address const& r)
+{
+	return !(l < r) && !(l > r);
+}
+
+inline bool operator!=(Address const& l, Address const& r)
+{
+	return !(l == r);
+}
+
+inline std::string to_string(Address const& addr)
+{
+	return addr.path();
+}
+
+}}
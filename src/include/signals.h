@@ -26,6 +26,8 @@
 
 #pragma once
 
+#include "inline-function.h"
+
 #include <algorithm>
 #include <functional>
 #include <memory>
@@ -35,6 +37,13 @@
 class CallbackBase {
 public:
 	virtual void disconnect() = 0;
+
+	// a callback may outlive its disconnection for a while
+	virtual bool connected() const
+	{
+		return true;
+	}
+
 	virtual ~CallbackBase() = default;
 };
 
@@ -86,7 +95,8 @@ public:
 
 	bool connected() const
 	{
-		return !cb_.expired();
+		auto cb(cb_.lock());
+		return cb && cb->connected();
 	}
 
 	void disconnect()
@@ -154,7 +164,7 @@ public:
 	SignalProxy & operator=(SignalProxy const&) = delete;
 	SignalProxy & operator=(SignalProxy &&) = delete;
 
-	virtual Connection connect(std::function<T> const&) = 0;
+	virtual Connection connect(InlineFunction<T>) = 0;
 	virtual ~SignalProxy() = default;
 };
 
@@ -165,12 +175,17 @@ public:
 
 	Signal(Signal && o)
 	:
-		cb_(std::move(o.cb_))
-	{ }
+		cb_(std::move(o.cb_)),
+		tombstones_(std::exchange(o.tombstones_, 0))
+	{
+		adopt_callbacks();
+	}
 
 	Signal & operator=(Signal && o)
 	{
 		cb_ = std::move(o.cb_);
+		tombstones_ = std::exchange(o.tombstones_, 0);
+		adopt_callbacks();
 		return *this;
 	}
 
@@ -179,23 +194,45 @@ public:
 	Signal(Signal const&) = delete;
 	Signal & operator=(Signal const&) = delete;
 
+	// A signal may be destroyed by one of its callbacks, the remaining
+	// callbacks are not invoked then. The callbacks are handed over to
+	// the outermost emission, so the running closure stays alive until
+	// the emission unwinds.
+	~Signal()
+	{
+		if (!emission_) {
+			return;
+		}
+
+		auto outermost = emission_;
+		for (auto emission = emission_; emission; emission = emission->prev) {
+			emission->destroyed = true;
+			outermost = emission;
+		}
+
+		for (auto const& cb : cb_) {
+			cb->owner = nullptr;
+		}
+		outermost->orphans = std::move(cb_);
+	}
+
 	size_t slots() const
 	{
-		return cb_.size();
+		return cb_.size() - tombstones_;
 	}
 
 	// The callback will not be called for any already active invokation
 	// of this signal at the time connect() is called.
-	Connection connect(std::function<T> const& cb) final
+	Connection connect(InlineFunction<T> cb) final
 	{
-		return Connection(add_callback(cb));
+		return Connection(add_callback(std::move(cb)));
 	}
 
 	template <typename... Args>
 	void operator()(Args && ...args)
 	{
 		if (!cb_.empty()) {
-			call_each({cb_.begin(), cb_.end()}, std::forward<Args>(args)...);
+			call_each(args...);
 		}
 	}
 
@@ -203,58 +240,121 @@ public:
 	void operator()(Args && ...args) const
 	{
 		if (!cb_.empty()) {
-			call_each({cb_.begin(), cb_.end()}, std::forward<Args>(args)...);
+			call_each(args...);
 		}
 	}
 
 private:
 	struct Callback : public CallbackBase {
-		Callback(Signal<T> *owner_, std::function<T> const& fn_)
+		Callback(Signal<T> *owner_, InlineFunction<T> && fn_)
 		:
 			owner(owner_),
-			fn(fn_)
+			fn(std::move(fn_))
 		{ }
 
 		void disconnect() final
 		{
 			if (owner) {
-				owner->del_callback(this);
-				owner = nullptr;
-				fn = nullptr;
+				std::exchange(owner, nullptr)->del_callback(this);
 			}
 		}
 
+		bool connected() const final
+		{
+			return owner != nullptr;
+		}
+
 		Signal<T> *owner;
-		std::function<T> fn;
+		InlineFunction<T> fn;
 	};
 
-	std::shared_ptr<Callback> add_callback(std::function<T> const& fn)
+	// Emissions are tracked on the stack, nested emissions form a
+	// list. Callbacks disconnected while any emission is active stay in
+	// cb_ as tombstones, so the slots can be iterated in place, and
+	// are removed once the outermost emission is done.
+	struct Emission {
+		explicit Emission(Signal const& sig_)
+		:
+			sig(sig_),
+			prev(sig_.emission_)
+		{
+			sig.emission_ = this;
+		}
+
+		~Emission()
+		{
+			if (destroyed) {
+				return;
+			}
+
+			sig.emission_ = prev;
+			if (!prev && sig.tombstones_ != 0) {
+				sig.compact();
+			}
+		}
+
+		Signal const& sig;
+		Emission *prev;
+		bool destroyed = false;
+		// callbacks of a signal destroyed during this emission
+		std::vector<std::shared_ptr<Callback>> orphans;
+	};
+
+	std::shared_ptr<Callback> add_callback(InlineFunction<T> && fn)
 	{
-		cb_.push_back(std::make_shared<Callback>(this, fn));
+		cb_.push_back(std::make_shared<Callback>(this, std::move(fn)));
 		return cb_.back();
 	}
 
 	void del_callback(Callback * cb)
 	{
+		if (emission_) {
+			++tombstones_;
+			return;
+		}
+
 		auto it(std::find_if(cb_.begin(), cb_.end(),
 			[cb](auto const& ptr) { return ptr.get() == cb; }));
-
-		it->reset();
 		cb_.erase(it);
 	}
 
+	void compact() const
+	{
+		cb_.erase(std::remove_if(cb_.begin(), cb_.end(),
+			[](auto const& cb) { return !cb->owner; }), cb_.end());
+		tombstones_ = 0;
+	}
+
+	void adopt_callbacks()
+	{
+		for (auto const& cb : cb_) {
+			if (cb->owner) {
+				cb->owner = this;
+			}
+		}
+	}
+
+	// Iterate by index, callbacks connected meanwhile may grow cb_
+	// but are not called by this emission.
 	template <typename... Args>
-	static void call_each(std::vector<std::weak_ptr<Callback>> cbs, Args && ...args)
+	void call_each(Args & ...args) const
 	{
-		for (auto ptr: cbs) {
-			auto cb(ptr.lock());
-			if (cb) {
-				std::invoke(cb->fn, std::forward<Args>(args)...);
+		auto emission = Emission{*this};
+		for (size_t i{0}, size{cb_.size()}; i < size; ++i) {
+			auto cb = cb_[i].get();
+			if (cb->owner) {
+				cb->fn(args...);
+				if (emission.destroyed) {
+					return;
+				}
 			}
 		}
 	}
 
-	std::vector<std::shared_ptr<Callback>> cb_;
+	// mutable to let const emissions remove tombstones
+	mutable std::vector<std::shared_ptr<Callback>> cb_;
+	mutable size_t tombstones_ = 0;
+	mutable Emission *emission_ = nullptr;
 };
 
 template <typename T>
@@ -282,10 +382,10 @@ public:
 
 	// The callback will not be called for any already active invokation
 	// of this signal at the time connect() is called.
-	Connection connect(std::function<T> const& fn) final
+	Connection connect(InlineFunction<T> fn) final
 	{
 		cb_ = std::make_shared<Callback>(this);
-		fn_ = fn;
+		fn_ = std::move(fn);
 		return Connection(cb_);
 	}
 
@@ -330,7 +430,7 @@ private:
 	}
 
 	std::shared_ptr<Callback> cb_{nullptr};
-	std::function<T> fn_{nullptr};
+	InlineFunction<T> fn_;
 };
 
 template <typename T>
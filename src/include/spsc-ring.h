@@ -0,0 +1,116 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+/*
+   Bounded lock-free queue for exactly one producer and one consumer
+   thread. The capacity is rounded up to a power of two.
+*/
+template <typename T>
+class SpscRing {
+public:
+	explicit SpscRing(size_t capacity)
+	:
+		mask_(round_up(capacity) - 1),
+		slots_(std::make_unique<std::optional<T>[]>(mask_ + 1))
+	{ }
+
+	SpscRing(SpscRing const&) = delete;
+	SpscRing & operator=(SpscRing const&) = delete;
+
+	size_t capacity() const
+	{
+		return mask_ + 1;
+	}
+
+	// producer only, false if the ring is full and value was not moved
+	bool try_push(T && value)
+	{
+		auto tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_cache_ > mask_) {
+			head_cache_ = head_.load(std::memory_order_acquire);
+			if (tail - head_cache_ > mask_) {
+				return false;
+			}
+		}
+
+		slots_[tail & mask_].emplace(std::move(value));
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only, empty if the ring is empty
+	std::optional<T> try_pop()
+	{
+		auto head = head_.load(std::memory_order_relaxed);
+		if (head == tail_cache_) {
+			tail_cache_ = tail_.load(std::memory_order_acquire);
+			if (head == tail_cache_) {
+				return {};
+			}
+		}
+
+		auto & slot = slots_[head & mask_];
+		auto res = std::optional<T>{std::move(*slot)};
+		slot.reset();
+		head_.store(head + 1, std::memory_order_release);
+		return res;
+	}
+
+	// exact only when called by the producer or the consumer
+	bool empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+private:
+	static size_t round_up(size_t n)
+	{
+		size_t res{1};
+		while (res < n) {
+			res <<= 1;
+		}
+		return res;
+	}
+
+	// keep the indices of producer and consumer on separate cache
+	// lines, each side caches the other's index to touch it less often
+	static constexpr size_t CacheLine = 64;
+
+	size_t const mask_;
+	std::unique_ptr<std::optional<T>[]> slots_;
+	alignas(CacheLine) std::atomic<size_t> head_{0};
+	size_t tail_cache_ = 0;
+	alignas(CacheLine) std::atomic<size_t> tail_{0};
+	size_t head_cache_ = 0;
+};
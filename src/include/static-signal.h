@@ -0,0 +1,99 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*
+   Signal whose slots are fixed at compile time.
+
+   The slots are stored by value and called in order as plain function
+   calls, so the compiler can inline them. There is no connection
+   management, use this for wiring which never changes at runtime and
+   Signal<T> for everything else. Both combine, a StaticSignal may be
+   connected to a Signal with std::ref() and vice versa.
+
+   Slots returning bool act as filters: false stops the emission and
+   the following slots are not called.
+*/
+template <typename... Slots>
+class StaticSignal {
+public:
+	constexpr explicit StaticSignal(Slots... slots)
+	:
+		slots_(std::move(slots)...)
+	{ }
+
+	template <typename... Args>
+	void operator()(Args && ...args) const
+	{
+		std::apply([&args...] (auto const& ...slots) {
+			(call(slots, args...) && ...);
+		}, slots_);
+	}
+
+private:
+	template <typename Slot, typename... Args>
+	static bool call(Slot const& slot, Args & ...args)
+	{
+		if constexpr (std::is_same_v<std::invoke_result_t<Slot const&, Args &...>, bool>) {
+			return std::invoke(slot, args...);
+		} else {
+			std::invoke(slot, args...);
+			return true;
+		}
+	}
+
+	std::tuple<Slots...> slots_;
+};
+
+// slot calling a member function fixed at compile time
+template <auto Method, typename Class>
+class MemberSlot {
+public:
+	constexpr explicit MemberSlot(Class & obj)
+	:
+		obj_(&obj)
+	{ }
+
+	template <typename... Args>
+	decltype(auto) operator()(Args && ...args) const
+	{
+		return std::invoke(Method, *obj_, std::forward<Args>(args)...);
+	}
+
+private:
+	Class *obj_;
+};
+
+template <auto Method, typename Class>
+constexpr MemberSlot<Method, Class> member_slot(Class & obj)
+{
+	return MemberSlot<Method, Class>(obj);
+}
@@ -0,0 +1,185 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "epoll/ctrl.h"
+#include "signals.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/*
+   Signal which may be emitted, connected to and disconnected from on
+   any thread.
+
+   Emission works on an immutable snapshot of the slot list, so it takes
+   no lock. Connecting and disconnecting copy the list under a mutex and
+   publish the new one atomically. A slot disconnected from another
+   thread may still see a call from an emission which already took its
+   snapshot.
+
+   A slot connected with an event loop is not called by the emitting
+   thread. The arguments are copied and the call is posted to the loop
+   instead (EPoll::Ctrl::post()), so the slot only ever runs on the
+   thread running that loop. Slots without a loop run on the emitting
+   thread and must cope with concurrent emissions themselves.
+
+   The signal keeps a plain pointer to the loop. Disconnect such a slot
+   before destroying its loop, and make sure no emission which may
+   still hold the slot is running on another thread. Posted calls go
+   through std::function, so every type in Args must be copy
+   constructible.
+*/
+template <typename T>
+class ThreadSafeSignal;
+
+template <typename... Args>
+class ThreadSafeSignal<void(Args...)> : public SignalProxy<void(Args...)> {
+public:
+	using Fn = InlineFunction<void(Args...)>;
+
+	ThreadSafeSignal() = default;
+	ThreadSafeSignal(ThreadSafeSignal const&) = delete;
+	ThreadSafeSignal & operator=(ThreadSafeSignal const&) = delete;
+
+	~ThreadSafeSignal()
+	{
+		auto lock = std::lock_guard<std::mutex>{state_->mutex};
+		for (auto const& cb : *state_->slots) {
+			cb->active = false;
+		}
+	}
+
+	size_t slots() const
+	{
+		return std::atomic_load(&state_->slots)->size();
+	}
+
+	Connection connect(Fn fn) final
+	{
+		return add_callback(std::move(fn), nullptr);
+	}
+
+	// fn is called on the thread running loop, which must outlive the
+	// connection
+	Connection connect(Fn fn, EPoll::Ctrl & loop)
+	{
+		static_assert((std::is_copy_constructible_v<std::decay_t<Args>> && ...),
+			"arguments posted to a loop must be copy constructible");
+		return add_callback(std::move(fn), &loop);
+	}
+
+	template <typename... A>
+	void operator()(A && ...args) const
+	{
+		auto slots = std::atomic_load(&state_->slots);
+		for (auto const& cb : *slots) {
+			if (!cb->connected()) {
+				continue;
+			}
+
+			if (cb->loop) {
+				cb->loop->post([cb, args = std::tuple<std::decay_t<Args>...>(args...)] () {
+					// may have been disconnected while queued
+					if (cb->connected()) {
+						std::apply(cb->fn, args);
+					}
+				});
+			} else {
+				cb->fn(args...);
+			}
+		}
+	}
+
+private:
+	struct Callback;
+	using Slots = std::vector<std::shared_ptr<Callback>>;
+
+	struct State {
+		std::mutex mutex;
+		std::shared_ptr<Slots const> slots{std::make_shared<Slots const>()};
+	};
+
+	struct Callback : public CallbackBase {
+		Callback(std::weak_ptr<State> const& state_, Fn && fn_, EPoll::Ctrl *loop_)
+		:
+			state(state_),
+			fn(std::move(fn_)),
+			loop(loop_)
+		{ }
+
+		void disconnect() final
+		{
+			auto st = state.lock();
+			if (!st) {
+				return;
+			}
+
+			auto lock = std::lock_guard<std::mutex>{st->mutex};
+			if (!active.exchange(false)) {
+				return;
+			}
+
+			auto slots = std::make_shared<Slots>();
+			slots->reserve(st->slots->size() - 1);
+			for (auto const& cb : *st->slots) {
+				if (cb.get() != this) {
+					slots->push_back(cb);
+				}
+			}
+			std::atomic_store(&st->slots, std::shared_ptr<Slots const>(std::move(slots)));
+		}
+
+		bool connected() const final
+		{
+			return active;
+		}
+
+		std::weak_ptr<State> state;
+		Fn fn;
+		EPoll::Ctrl *loop;
+		std::atomic<bool> active{true};
+	};
+
+	Connection add_callback(Fn && fn, EPoll::Ctrl *loop)
+	{
+		auto cb = std::make_shared<Callback>(state_, std::move(fn), loop);
+
+		auto lock = std::lock_guard<std::mutex>{state_->mutex};
+		auto slots = std::make_shared<Slots>(*state_->slots);
+		slots->push_back(cb);
+		std::atomic_store(&state_->slots, std::shared_ptr<Slots const>(std::move(slots)));
+		return Connection(cb);
+	}
+
+	// shared with the callbacks, which may be disconnected after the
+	// signal is gone
+	std::shared_ptr<State> state_{std::make_shared<State>()};
+};
@@ -0,0 +1,130 @@
+/*
+   Copyright (c) 2021 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utest/source-location.h"
+#include "utest/type-name.h"
+
+namespace UBench {
+
+// Passed to each benchmark, which runs its operation iterations()
+// times. Work which should not be measured can be bracketed with
+// stop_timer() and start_timer().
+class State {
+public:
+	explicit State(uint64_t iterations)
+	:
+		iterations_(iterations)
+	{ }
+
+	uint64_t iterations() const
+	{
+		return iterations_;
+	}
+
+	// bytes processed per iteration, used to report throughput
+	void set_bytes(uint64_t bytes)
+	{
+		bytes_ = bytes;
+	}
+
+	uint64_t bytes() const
+	{
+		return bytes_;
+	}
+
+	void start_timer()
+	{
+		start_ = std::chrono::steady_clock::now();
+	}
+
+	void stop_timer()
+	{
+		elapsed_ += std::chrono::steady_clock::now() - start_;
+	}
+
+	std::chrono::nanoseconds elapsed() const
+	{
+		return elapsed_;
+	}
+
+private:
+	uint64_t iterations_;
+	uint64_t bytes_ = 0;
+	std::chrono::steady_clock::time_point start_;
+	std::chrono::nanoseconds elapsed_{0};
+};
+
+class Registry {
+public:
+	static Registry & get();
+
+	void register_bench(std::string const&, SourceLocation const&, std::function<void(State &)> const&);
+
+	struct Bench {
+		std::string name;
+		SourceLocation loc;
+		std::function<void(State &)> run;
+	};
+
+	using const_iterator = std::vector<Bench>::const_iterator;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	std::vector<Bench> benches_;
+};
+
+template <typename T>
+class Registrator {
+public:
+	Registrator(SourceLocation loc)
+	{
+		Registry::get().register_bench(UTest::type_name<T>(), loc, [](State & state) {
+			auto bench = std::make_unique<T>();
+			state.start_timer();
+			(*bench)(state);
+			state.stop_timer();
+		});
+	}
+};
+
+// keep the compiler from optimizing away the computation of value
+template <typename T>
+inline void do_not_optimize(T const& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}
@@ -0,0 +1,272 @@
+/*
+   Copyright (c) 2023 Andreas Fett
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+   * Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+   * Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+   SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+   CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+   OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <sys/types.h>
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace UDev {
+
+/*
+   Immutable copy of everything libudev reports about a device.
+
+   All strings live in a single arena, the lists are one flat vector of
+   key/value views sorted by list and key, so a snapshot costs three
+   allocations no matter how many properties the device has. Lookups
+   are binary searches and never call into libudev again.
+
+   The views returned by a snapshot are valid as long as the snapshot.
+*/
+class DeviceSnapshot {
+public:
+	enum class Field {
+		Devpath,
+		Subsystem,
+		Devtype,
+		Syspath,
+		Sysname,
+		Sysnum,
+		Devnode,
+		Driver,
+		Action,
+	};
+	static constexpr size_t Fields = size_t(Field::Action) + 1;
+
+	enum class List {
+		Devlinks,
+		Properties,
+		Tags,
+		CurrentTags,
+		Sysattr,
+	};
+	static constexpr size_t Lists = size_t(List::Sysattr) + 1;
+
+	using Entry = std::pair<std::string_view, std::string_view>;
+
+	// sorted, unique keys
+	class Map {
+	public:
+		using const_iterator = Entry const*;
+
+		Map() = default;
+
+		Map(const_iterator begin, const_iterator end)
+		:
+			begin_(begin),
+			end_(end)
+		{ }
+
+		const_iterator begin() const
+		{
+			return begin_;
+		}
+
+		const_iterator end() const
+		{
+			return end_;
+		}
+
+		size_t size() const
+		{
+			return size_t(end_ - begin_);
+		}
+
+		bool empty() const
+		{
+			return begin_ == end_;
+		}
+
+		const_iterator find(std::string_view) const;
+
+		bool contains(std::string_view key) const
+		{
+			return find(key) != end_;
+		}
+
+		// empty if the key is missing
+		std::string_view value(std::string_view) const;
+
+		std::map<std::string, std::string> to_map() const;
+
+	private:
+		const_iterator begin_ = nullptr;
+		const_iterator end_ = nullptr;
+	};
+
+	class Builder;
+
+	DeviceSnapshot(DeviceSnapshot const&) = delete;
+	DeviceSnapshot & operator=(DeviceSnapshot const&) = delete;
+	DeviceSnapshot(DeviceSnapshot &&) = default;
+	DeviceSnapshot & operator=(DeviceSnapshot &&) = default;
+
+	// false if libudev returned no value for the field
+	bool has(Field field) const
+	{
+		return fields_[size_t(field)].data() != nullptr;
+	}
+
+	// empty if the field has no value
+	std::string_view get(Field field) const
+	{
+		return fields_[size_t(field)];
+	}
+
+	Map get(List list) const
+	{
+		auto const& range = lists_[size_t(list)];
+		return Map{entries_.data() + range.first, entries_.data() + range.second};
+	}
+
+	std::string_view devpath() const { return get(Field::Devpath); }
+	std::string_view subsystem() const { return get(Field::Subsystem); }
+	std::string_view devtype() const { return get(Field::Devtype); }
+	std::string_view syspath() const { return get(Field::Syspath); }
+	std::string_view sysname() const { return get(Field::Sysname); }
+	std::string_view sysnum() const { return get(Field::Sysnum); }
+	std::string_view devnode() const { return get(Field::Devnode); }
+	std::string_view driver() const { return get(Field::Driver); }
+	std::string_view action() const { return get(Field::Action); }
+
+	Map devlinks() const { return get(List::Devlinks); }
+	Map properties() const { return get(List::Properties); }
+	Map tags() const { return get(List::Tags); }
+	Map current_tags() const { return get(List::CurrentTags); }
+	// attribute names only, libudev reads the values lazily from sysfs
+	Map sysattr() const { return get(List::Sysattr); }
+
+	std::string_view property_value(std::string_view key) const
+	{
+		return properties().value(key);
+	}
+
+	bool has_tag(std::string_view tag) const
+	{
+		return tags().contains(tag);
+	}
+
+	bool has_current_tag(std::string_view tag) const
+	{
+		return current_tags().contains(tag);
+	}
+
+	bool is_initialized() const
+	{
+		return is_initialized_;
+	}
+
+	dev_t devnum() const
+	{
+		return devnum_;
+	}
+
+	unsigned long long int seqnum() const
+	{
+		return seqnum_;
+	}
+
+	unsigned long long int usec_since_initialized() const
+	{
+		return usec_since_initialized_;
+	}
+
+private:
+	DeviceSnapshot() = default;
+
+	// the arena is a vector since moving it keeps the views valid,
+	// unlike a std::string holding a short string inline
+	std::vector<char> arena_;
+	std::vector<Entry> entries_;
+	std::array<std::string_view, Fields> fields_ = {};
+	std::array<std::pair<size_t, size_t>, Lists> lists_ = {};
+	bool is_initialized_ = false;
+	dev_t devnum_ = 0;
+	unsigned long long int seqnum_ = 0;
+	unsigned long long int usec_since_initialized_ = 0;
+};
+
+// Collects the attributes of a device, duplicate list keys keep the
+// first value like insertion into a std::map.
+class DeviceSnapshot::Builder {
+public:
+	Builder & set(Field, std::string_view);
+	Builder & add(List, std::string_view key, std::string_view value = {});
+
+	Builder & is_initialized(bool value)
+	{
+		snapshot_.is_initialized_ = value;
+		return *this;
+	}
+
+	Builder & devnum(dev_t value)
+	{
+		snapshot_.devnum_ = value;
+		return *this;
+	}
+
+	Builder & seqnum(unsigned long long int value)
+	{
+		snapshot_.seqnum_ = value;
+		return *this;
+	}
+
+	Builder & usec_since_initialized(unsigned long long int value)
+	{
+		snapshot_.usec_since_initialized_ = value;
+		return *this;
+	}
+
+	DeviceSnapshot build();
+
+private:
+	struct Ref {
+		size_t offset = 0;
+		size_t size = 0;
+		bool valid = false;
+	};
+
+	struct EntryRef {
+		List list;
+		Ref key;
+		Ref value;
+	};
+
+	Ref append(std::string_view);
+
+	std::string arena_;
+	std::array<Ref, Fields> fields_ = {};
+	std::vector<EntryRef> entries_;
+	DeviceSnapshot snapshot_;
+};
+
+}
@@ -30,6 +30,8 @@
 #include <memory>
 #include <string>
 
+#include "udev-device-snapshot.h"
+
 namespace UDev {
 
 class Device {
@@ -46,6 +48,8 @@ public:
 	virtual std::string devnode() const = 0;
 
 	virtual bool is_initialized() const = 0;
+	// each call returns a new copy, use snapshot() to look at the
+	// lists more than once
 	virtual std::map<std::string, std::string> devlinks() const = 0;
 	virtual std::map<std::string, std::string> properties() const = 0;
 	virtual std::map<std::string, std::string> tags() const = 0;
@@ -62,6 +66,11 @@ public:
 	virtual void sysattr_value(std::string const& sysattr, std::string const& value) = 0;
 	virtual bool has_tag(std::string const& tag) const = 0;
 	virtual bool has_current_tag(std::string const& tag) const = 0;
+
+	// All attributes read once, cheaper than the getters above when
+	// the device is queried repeatedly. Building it reads the sysattr
+	// list from sysfs, the getters only use it once it exists.
+	virtual std::shared_ptr<DeviceSnapshot const> snapshot() const = 0;
 };
 
 class Monitor {
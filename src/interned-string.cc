@@ -0,0 +1,66 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "interned-string.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+class Pool {
+public:
+	std::string const* intern(std::string_view const& str)
+	{
+		auto lock = std::lock_guard<std::mutex>{mutex_};
+		if (auto it = index_.find(str); it != index_.end()) {
+			return it->second;
+		}
+
+		// deque never moves its elements, so the views into them
+		// used as keys stay valid
+		auto const& res = strings_.emplace_back(str);
+		index_.emplace(res, &res);
+		return &res;
+	}
+
+	size_t size()
+	{
+		auto lock = std::lock_guard<std::mutex>{mutex_};
+		return strings_.size();
+	}
+
+private:
+	std::mutex mutex_;
+	std::deque<std::string> strings_;
+	std::unordered_map<std::string_view, std::string const*> index_;
+};
+
+// never destroyed, handles may outlive static destructors
+Pool & pool()
+{
+	static auto res = new Pool;
+	return *res;
+}
+
+}
+
+InternedString::InternedString()
+{
+	static auto const empty = pool().intern({});
+	str_ = empty;
+}
+
+InternedString::InternedString(std::string_view const& str)
+:
+	str_(pool().intern(str))
+{ }
+
+size_t InternedString::pool_size()
+{
+	return pool().size();
+}
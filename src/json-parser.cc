@@ -77,6 +77,7 @@ Json::Value parse_value(std::istream & in, size_t depth)
 
 std::pair<std::string, Json::Value> parse_member(std::istream & in, size_t depth)
 {
+	parse_whitespace(in);
 	auto key{parse_string(in)};
 	parse_whitespace(in);
 	if (in.get() != ':') {
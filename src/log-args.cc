@@ -0,0 +1,146 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "log/args.h"
+#include "fmt.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Log {
+
+static_assert(Args::Capacity <= UINT8_MAX, "size must fit into uint8_t");
+
+void Args::put_string(std::string_view str)
+{
+	if (full_ || size_ + 2u > Capacity) {
+		full_ = true;
+		return;
+	}
+
+	auto len = std::min(str.size(), Capacity - size_ - 2);
+	data_[size_++] = char(Tag::String);
+	data_[size_++] = char(len);
+
+	// Copy in fixed size blocks. Given the bounded size gcc turns a
+	// single memcpy into rep movs, which is slow for short strings.
+	auto dst = data_ + size_;
+	size_t n{0};
+	for (; n + 16 <= len; n += 16) {
+		std::memcpy(dst + n, str.data() + n, 16);
+	}
+	for (; n < len; ++n) {
+		dst[n] = str[n];
+	}
+	size_ += len;
+	++count_;
+}
+
+namespace {
+
+class Decoder {
+public:
+	explicit Decoder(std::string_view data)
+	:
+		data_(data)
+	{ }
+
+	bool done() const
+	{
+		return data_.empty();
+	}
+
+	template <typename T>
+	T get()
+	{
+		T res;
+		std::memcpy(&res, take(sizeof(res)).data(), sizeof(res));
+		return res;
+	}
+
+	std::string_view take(size_t size)
+	{
+		if (size > data_.size()) {
+			throw std::runtime_error("log: truncated arguments");
+		}
+		auto res = data_.substr(0, size);
+		data_.remove_prefix(size);
+		return res;
+	}
+
+	// decode the next argument and pass it to fn
+	template <typename Fn>
+	void visit(Fn && fn)
+	{
+		switch (Args::Tag(get<uint8_t>())) {
+		case Args::Tag::Bool:
+			fn(get<uint8_t>() != 0);
+			return;
+		case Args::Tag::Char:
+			fn(get<char>());
+			return;
+		case Args::Tag::Int16:
+			fn(get<int16_t>());
+			return;
+		case Args::Tag::Int32:
+			fn(get<int32_t>());
+			return;
+		case Args::Tag::Int64:
+			fn(get<int64_t>());
+			return;
+		case Args::Tag::UInt16:
+			fn(get<uint16_t>());
+			return;
+		case Args::Tag::UInt32:
+			fn(get<uint32_t>());
+			return;
+		case Args::Tag::UInt64:
+			fn(get<uint64_t>());
+			return;
+		case Args::Tag::Double:
+			fn(get<double>());
+			return;
+		case Args::Tag::String:
+			fn(take(get<uint8_t>()));
+			return;
+		}
+		throw std::runtime_error("log: invalid argument tag");
+	}
+
+private:
+	std::string_view data_;
+};
+
+}
+
+Args Args::from_bytes(std::string_view bytes)
+{
+	if (bytes.size() > Capacity) {
+		throw std::runtime_error("log: arguments too long");
+	}
+
+	auto res = Args{};
+	std::memcpy(res.data_, bytes.data(), bytes.size());
+	res.size_ = bytes.size();
+
+	// validates the data as well
+	auto dec = Decoder{bytes};
+	while (!dec.done()) {
+		dec.visit([] (auto const&) { });
+		++res.count_;
+	}
+	return res;
+}
+
+void Args::format(std::string & out, std::string_view fmt) const
+{
+	auto dec = Decoder{bytes()};
+	auto sink = Fmt::Detail::StringOut{out};
+	Fmt::Detail::format_with(sink, fmt, count_, [&dec] (auto & o, size_t, char spec) {
+		dec.visit([&o, spec] (auto const& value) { Fmt::Detail::write_arg(o, spec, value); });
+	});
+}
+
+}
@@ -0,0 +1,284 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "log/async-logger.h"
+#include "posix/system-error.h"
+#include "spsc-ring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Log {
+
+namespace {
+
+// a writer which found nothing to do sleeps at most this long, this
+// bounds the delay of a wakeup lost to the lock-free post()
+constexpr auto IdleWait = std::chrono::milliseconds(10);
+
+struct Ring {
+	explicit Ring(size_t capacity)
+	:
+		messages(capacity)
+	{ }
+
+	SpscRing<Message> messages;
+	std::atomic<uint64_t> posted{0};
+	std::atomic<uint64_t> dropped{0};
+};
+
+// unique per logger instance, unlike its address
+std::atomic<uint64_t> next_id{0};
+
+}
+
+class AsyncLoggerImpl : public AsyncLogger {
+public:
+	AsyncLoggerImpl(Logger const&, Params const&);
+	~AsyncLoggerImpl() override;
+
+	void post(Message &&) final;
+	void flush() final;
+	Stats stats() const final;
+
+private:
+	Ring & ring();
+	void run();
+	bool drain();
+	void reap();
+	void wakeup();
+	uint64_t posted() const;
+
+	Logger const& logger_;
+	Params params_;
+	uint64_t id_{next_id++};
+
+	mutable std::mutex mutex_;
+	std::condition_variable cond_;
+	std::vector<std::shared_ptr<Ring>> rings_;
+	// bumped whenever rings_ changes
+	std::atomic<uint64_t> generation_{0};
+	// counters of removed rings
+	uint64_t retired_posted_ = 0;
+	uint64_t retired_dropped_ = 0;
+	bool stop_ = false;
+	std::atomic<bool> idle_{false};
+	std::atomic<uint64_t> written_{0};
+
+	// owned by the writer thread, a copy of rings_ as of draining_generation_
+	std::vector<Ring *> draining_;
+	uint64_t draining_generation_ = 0;
+
+	std::thread writer_;
+};
+
+std::unique_ptr<AsyncLogger> AsyncLogger::create(Logger const& logger, Params const& params)
+{
+	return std::make_unique<AsyncLoggerImpl>(logger, params);
+}
+
+AsyncLoggerImpl::AsyncLoggerImpl(Logger const& logger, Params const& params)
+:
+	logger_(logger),
+	params_(params)
+{
+	// signals are meant for the threads of the application, the writer
+	// thread inherits the mask of its creator
+	sigset_t all;
+	::sigfillset(&all);
+	sigset_t old;
+	auto err = ::pthread_sigmask(SIG_BLOCK, &all, &old);
+	if (err != 0) {
+		throw Posix::make_system_error(err, "::pthread_sigmask(SIG_BLOCK, %x, %x)", &all, &old);
+	}
+
+	try {
+		writer_ = std::thread([this] () { run(); });
+	} catch (...) {
+		::pthread_sigmask(SIG_SETMASK, &old, nullptr);
+		throw;
+	}
+	::pthread_sigmask(SIG_SETMASK, &old, nullptr);
+}
+
+AsyncLoggerImpl::~AsyncLoggerImpl()
+{
+	{
+		auto lock = std::lock_guard<std::mutex>{mutex_};
+		stop_ = true;
+	}
+	cond_.notify_one();
+	writer_.join();
+}
+
+Ring & AsyncLoggerImpl::ring()
+{
+	// Rings of this thread by logger id. The logger keeps a reference
+	// as well, so a ring outlives its thread until it is drained.
+	thread_local std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> rings;
+	for (auto const& [id, ring] : rings) {
+		if (id == id_) {
+			return *ring;
+		}
+	}
+
+	// forget rings of loggers destroyed meanwhile
+	rings.erase(std::remove_if(rings.begin(), rings.end(),
+		[](auto const& entry) { return entry.second.use_count() == 1; }), rings.end());
+
+	auto ring = std::make_shared<Ring>(params_.capacity);
+	{
+		auto lock = std::lock_guard<std::mutex>{mutex_};
+		rings_.push_back(ring);
+		generation_.fetch_add(1, std::memory_order_release);
+	}
+	rings.emplace_back(id_, ring);
+	return *ring;
+}
+
+void AsyncLoggerImpl::post(Message && msg)
+{
+	auto & r = ring();
+	while (!r.messages.try_push(std::move(msg))) {
+		if (params_.policy == Policy::Drop) {
+			r.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		wakeup();
+		std::this_thread::yield();
+	}
+	r.posted.fetch_add(1, std::memory_order_relaxed);
+	wakeup();
+}
+
+void AsyncLoggerImpl::wakeup()
+{
+	// only pay for the notification if the writer went to sleep, the
+	// fence orders the push before reading idle_
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (idle_.load(std::memory_order_relaxed)) {
+		cond_.notify_one();
+	}
+}
+
+void AsyncLoggerImpl::flush()
+{
+	auto target = posted();
+	while (written_.load() < target) {
+		cond_.notify_one();
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+}
+
+uint64_t AsyncLoggerImpl::posted() const
+{
+	auto lock = std::lock_guard<std::mutex>{mutex_};
+	auto res = retired_posted_;
+	for (auto const& ring : rings_) {
+		res += ring->posted.load();
+	}
+	return res;
+}
+
+AsyncLogger::Stats AsyncLoggerImpl::stats() const
+{
+	auto res = Stats{};
+	auto lock = std::lock_guard<std::mutex>{mutex_};
+	res.posted = retired_posted_;
+	res.dropped = retired_dropped_;
+	for (auto const& ring : rings_) {
+		res.posted += ring->posted.load(std::memory_order_relaxed);
+		res.dropped += ring->dropped.load(std::memory_order_relaxed);
+	}
+	res.written = written_.load(std::memory_order_relaxed);
+	return res;
+}
+
+void AsyncLoggerImpl::run()
+{
+	for (;;) {
+		if (drain()) {
+			continue;
+		}
+
+		auto lock = std::unique_lock<std::mutex>{mutex_};
+		if (stop_) {
+			break;
+		}
+		reap();
+		idle_ = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto pending = std::any_of(rings_.begin(), rings_.end(),
+			[](auto const& ring) { return !ring->messages.empty(); });
+		if (!pending) {
+			cond_.wait_for(lock, IdleWait);
+		}
+		idle_ = false;
+	}
+
+	// rings may have been filled right before stop_ was set
+	while (drain()) {
+	}
+}
+
+bool AsyncLoggerImpl::drain()
+{
+	// only look at rings_ again when a ring was added or removed
+	if (generation_.load(std::memory_order_acquire) != draining_generation_) {
+		auto lock = std::lock_guard<std::mutex>{mutex_};
+		draining_.clear();
+		for (auto const& ring : rings_) {
+			draining_.push_back(ring.get());
+		}
+		draining_generation_ = generation_.load(std::memory_order_relaxed);
+	}
+
+	auto res{false};
+	for (auto ring : draining_) {
+		while (auto msg = ring->messages.try_pop()) {
+			logger_.post(*msg);
+			written_.fetch_add(1, std::memory_order_release);
+			res = true;
+		}
+	}
+	return res;
+}
+
+void AsyncLoggerImpl::reap()
+{
+	// Called with mutex_ held. Once rings_ holds the last reference
+	// the posting thread has exited and nothing is added anymore.
+	auto gone = [this] (auto const& ring) {
+		if (ring.use_count() != 1) {
+			return false;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (!ring->messages.empty()) {
+			return false;
+		}
+		retired_posted_ += ring->posted.load(std::memory_order_relaxed);
+		retired_dropped_ += ring->dropped.load(std::memory_order_relaxed);
+		return true;
+	};
+
+	auto it = std::remove_if(rings_.begin(), rings_.end(), gone);
+	if (it != rings_.end()) {
+		rings_.erase(it, rings_.end());
+		generation_.fetch_add(1, std::memory_order_release);
+	}
+}
+
+std::string to_string(AsyncLogger::Stats const& stats)
+{
+	return FMT_FORMAT("posted=%s dropped=%s written=%s", stats.posted, stats.dropped, stats.written);
+}
+
+}
@@ -0,0 +1,216 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "log/binary.h"
+#include "posix/fd.h"
+
+#include <stdexcept>
+
+namespace Log {
+namespace Binary {
+
+namespace {
+
+enum class Type : uint8_t {
+	Format,
+	Deferred,
+	Text,
+};
+
+void put_varint(std::string & buf, uint64_t value)
+{
+	while (value >= 0x80) {
+		buf.push_back(char(value | 0x80));
+		value >>= 7;
+	}
+	buf.push_back(char(value));
+}
+
+void put_string(std::string & buf, std::string_view const& str)
+{
+	put_varint(buf, str.size());
+	buf.append(str);
+}
+
+class Decoder {
+public:
+	explicit Decoder(std::string_view const& data)
+	:
+		data_(data)
+	{ }
+
+	uint64_t varint()
+	{
+		uint64_t res{0};
+		for (unsigned shift{0}; shift < 64; shift += 7) {
+			auto byte = uint8_t(take(1)[0]);
+			// the tenth byte only has room for bit 63
+			if (shift == 63 && (byte & 0x7e)) {
+				break;
+			}
+			res |= uint64_t(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				return res;
+			}
+		}
+		throw std::runtime_error("log: varint overflow");
+	}
+
+	std::string_view string()
+	{
+		return take(varint());
+	}
+
+	uint8_t byte()
+	{
+		return uint8_t(take(1)[0]);
+	}
+
+	std::string_view take(uint64_t size)
+	{
+		if (size > data_.size()) {
+			throw std::runtime_error("log: truncated record");
+		}
+		auto res = data_.substr(0, size);
+		data_.remove_prefix(size);
+		return res;
+	}
+
+	std::string_view rest() const
+	{
+		return data_;
+	}
+
+private:
+	std::string_view data_;
+};
+
+Level get_level(Decoder & dec)
+{
+	auto value = dec.byte();
+	if (value > uint8_t(Level::Error)) {
+		throw std::runtime_error("log: invalid level");
+	}
+	return Level(value);
+}
+
+}
+
+Writer::Writer(std::shared_ptr<Posix::Fd> const& fd)
+:
+	Writer(fd, Params{})
+{ }
+
+Writer::Writer(std::shared_ptr<Posix::Fd> const& fd, Params const& params)
+:
+	fd_(fd),
+	params_(params)
+{
+	buf_.reserve(params_.buffer_size);
+	buf_ = Magic;
+	flush();
+}
+
+Writer::~Writer()
+{
+	try {
+		flush();
+	} catch (...) {
+	}
+}
+
+void Writer::write(Message const& msg)
+{
+	if (!msg.format()) {
+		payload_.clear();
+		payload_.push_back(char(Type::Text));
+		payload_.push_back(char(msg.level()));
+		put_string(payload_, msg.get_msg());
+		add_record();
+	} else {
+		auto [it, inserted] = formats_.try_emplace(msg.format(), formats_.size());
+		if (inserted) {
+			payload_.clear();
+			payload_.push_back(char(Type::Format));
+			put_string(payload_, msg.format());
+			add_record();
+		}
+
+		payload_.clear();
+		payload_.push_back(char(Type::Deferred));
+		payload_.push_back(char(msg.level()));
+		put_varint(payload_, it->second);
+		payload_.append(msg.args().bytes());
+		add_record();
+	}
+
+	if (buf_.size() >= params_.buffer_size) {
+		flush();
+	}
+}
+
+void Writer::flush()
+{
+	size_t pos{0};
+	try {
+		while (pos < buf_.size()) {
+			pos += fd_->write(buf_.data() + pos, buf_.size() - pos);
+		}
+	} catch (...) {
+		// keep what was not written for the next attempt
+		buf_.erase(0, pos);
+		throw;
+	}
+	buf_.clear();
+}
+
+void Writer::add_record()
+{
+	put_varint(buf_, payload_.size());
+	buf_.append(payload_);
+}
+
+Reader::Reader(std::string_view const& data)
+:
+	data_(data)
+{
+	if (data_.substr(0, Magic.size()) != Magic) {
+		throw std::runtime_error("log: bad magic");
+	}
+	data_.remove_prefix(Magic.size());
+}
+
+bool Reader::next(Level & level, std::string & text)
+{
+	while (!data_.empty()) {
+		Decoder dec{data_};
+		auto payload = Decoder{dec.take(dec.varint())};
+		data_ = dec.rest();
+
+		switch (Type(payload.byte())) {
+		case Type::Format:
+			formats_.emplace_back(payload.string());
+			continue;
+		case Type::Deferred: {
+			level = get_level(payload);
+			auto id = payload.varint();
+			if (id >= formats_.size()) {
+				throw std::runtime_error("log: unknown format");
+			}
+			text.clear();
+			Args::from_bytes(payload.rest()).format(text, formats_[id]);
+			return true;
+		}
+		case Type::Text:
+			level = get_level(payload);
+			text = payload.string();
+			return true;
+		}
+		throw std::runtime_error("log: unknown record");
+	}
+	return false;
+}
+
+}}
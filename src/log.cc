@@ -0,0 +1,25 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "log.h"
+
+namespace Log {
+
+std::string to_string(Level level)
+{
+	switch (level) {
+	case Level::Debug:
+		return "debug";
+	case Level::Info:
+		return "info";
+	case Level::Warning:
+		return "warning";
+	case Level::Error:
+		return "error";
+	}
+	return "unknown";
+}
+
+}
@@ -22,10 +22,10 @@ void backtrace(std::exception const& e)
 
 }
 
-int main()
+int main(int argc, char *argv[])
 {
 	try {
-		return clingeling(0, nullptr);
+		return clingeling(argc, argv);
 	} catch (std::exception const& e) {
 		::backtrace(e);
 		return 1;
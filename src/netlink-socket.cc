@@ -27,6 +27,11 @@ public:
 		return socket_->set_recvbuf(size);
 	}
 
+	void set_nodelay(bool on) const override
+	{
+		socket_->set_nodelay(on);
+	}
+
 	int get() const override
 	{
 		return socket_->get();
@@ -54,6 +59,16 @@ public:
 		socket_->connect(addr);
 	}
 
+	void listen(int backlog) const override
+	{
+		socket_->listen(backlog);
+	}
+
+	std::shared_ptr<Posix::Socket> accept(Posix::Fd::Options const& options) const override
+	{
+		return socket_->accept(options);
+	}
+
 private:
 	std::shared_ptr<Posix::Socket> socket_;
 };
@@ -0,0 +1,225 @@
+/*
+   Copyright (c) 2023 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "netlink/uevent.h"
+
+#include <endian.h>
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// struct monitor_netlink_header of libudev/sd-device
+struct UdevHeader {
+	char prefix[8];
+	uint32_t magic;
+	uint32_t header_size;
+	uint32_t properties_off;
+	uint32_t properties_len;
+	uint32_t filter_subsystem_hash;
+	uint32_t filter_devtype_hash;
+	uint32_t filter_tag_bloom_hi;
+	uint32_t filter_tag_bloom_lo;
+};
+
+constexpr auto UdevPrefix = std::string_view("libudev\0", 8);
+constexpr uint32_t UdevMagic = 0xfeedcafe;
+
+std::optional<UdevHeader> udev_header(std::string_view datagram)
+{
+	if (datagram.size() < sizeof(UdevHeader) || datagram.substr(0, UdevPrefix.size()) != UdevPrefix) {
+		return std::nullopt;
+	}
+
+	auto header = UdevHeader{};
+	std::memcpy(&header, datagram.data(), sizeof(header));
+	if (be32toh(header.magic) != UdevMagic) {
+		return std::nullopt;
+	}
+	return header;
+}
+
+}
+
+namespace Netlink {
+
+void UEvent::Iterator::next()
+{
+	while (!rest_.empty()) {
+		auto entry = rest_.substr(0, rest_.find('\0'));
+		rest_.remove_prefix(std::min(entry.size() + 1, rest_.size()));
+
+		auto eq = entry.find('=');
+		if (eq == std::string_view::npos) {
+			continue;
+		}
+		prop_ = {entry.substr(0, eq), entry.substr(eq + 1)};
+		end_ = false;
+		return;
+	}
+	end_ = true;
+}
+
+std::optional<UEvent> UEvent::parse(std::string_view datagram)
+{
+	return parse(datagram, UEventFilter{});
+}
+
+std::optional<UEvent> UEvent::parse(std::string_view datagram, UEventFilter const& filter)
+{
+	if (datagram.empty() || datagram.back() != '\0') {
+		return std::nullopt;
+	}
+
+	auto res = std::optional<UEvent>{};
+	if (auto header = udev_header(datagram)) {
+		// filter on the hashes before touching the properties, most
+		// events are not interesting
+		if (!filter.empty() && !filter.match_hashes(
+				be32toh(header->filter_subsystem_hash),
+				be32toh(header->filter_devtype_hash))) {
+			return std::nullopt;
+		}
+
+		auto off = size_t(header->properties_off);
+		auto len = size_t(header->properties_len);
+		if (off < sizeof(UdevHeader) || off > datagram.size() || len == 0 || len > datagram.size() - off) {
+			return std::nullopt;
+		}
+		auto properties = datagram.substr(off, len);
+		if (properties.back() != '\0') {
+			return std::nullopt;
+		}
+		res = parse_properties(Source::Udev, properties);
+	} else {
+		// ACTION@DEVPATH, the same values are repeated in the properties
+		auto head = datagram.substr(0, datagram.find('\0'));
+		if (head.find('@') == std::string_view::npos) {
+			return std::nullopt;
+		}
+		res = parse_properties(Source::Kernel, datagram.substr(head.size() + 1));
+	}
+
+	if (!res || !filter.match(res->subsystem_, res->devtype_)) {
+		return std::nullopt;
+	}
+	return res;
+}
+
+std::optional<UEvent> UEvent::parse_properties(Source source, std::string_view properties)
+{
+	auto res = UEvent{};
+	res.source_ = source;
+	res.properties_ = properties;
+
+	for (auto const& [key, value] : res) {
+		if (key == "ACTION") {
+			res.action_ = value;
+		} else if (key == "DEVPATH") {
+			res.devpath_ = value;
+		} else if (key == "SUBSYSTEM") {
+			res.subsystem_ = value;
+		} else if (key == "DEVTYPE") {
+			res.devtype_ = value;
+		} else if (key == "SEQNUM") {
+			auto end = value.data() + value.size();
+			auto [ptr, ec] = std::from_chars(value.data(), end, res.seqnum_);
+			if (ec != std::errc{} || ptr != end) {
+				return std::nullopt;
+			}
+		}
+	}
+
+	if (res.action_.empty() || res.devpath_.empty() || res.subsystem_.empty()) {
+		return std::nullopt;
+	}
+	return res;
+}
+
+std::string_view UEvent::get(std::string_view key) const
+{
+	for (auto const& prop : *this) {
+		if (prop.first == key) {
+			return prop.second;
+		}
+	}
+	return {};
+}
+
+void UEventFilter::add_match_subsystem_devtype(std::string_view subsystem, std::string_view devtype)
+{
+	matches_.push_back({std::string{subsystem}, std::string{devtype}, hash(subsystem), hash(devtype)});
+}
+
+bool UEventFilter::match(std::string_view subsystem, std::string_view devtype) const
+{
+	if (matches_.empty()) {
+		return true;
+	}
+
+	for (auto const& m : matches_) {
+		if (m.subsystem == subsystem && (m.devtype.empty() || m.devtype == devtype)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UEventFilter::match_hashes(uint32_t subsystem_hash, uint32_t devtype_hash) const
+{
+	if (matches_.empty()) {
+		return true;
+	}
+
+	for (auto const& m : matches_) {
+		if (m.subsystem_hash == subsystem_hash && (m.devtype.empty() || m.devtype_hash == devtype_hash)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t UEventFilter::hash(std::string_view str)
+{
+	constexpr uint32_t m = 0x5bd1e995;
+	constexpr int r = 24;
+
+	auto len = str.size();
+	auto data = reinterpret_cast<unsigned char const*>(str.data());
+	uint32_t h = uint32_t(len);
+
+	while (len >= 4) {
+		uint32_t k;
+		std::memcpy(&k, data, sizeof(k));
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h *= m;
+		h ^= k;
+		data += 4;
+		len -= 4;
+	}
+
+	switch (len) {
+	case 3:
+		h ^= uint32_t(data[2]) << 16;
+		[[fallthrough]];
+	case 2:
+		h ^= uint32_t(data[1]) << 8;
+		[[fallthrough]];
+	case 1:
+		h ^= data[0];
+		h *= m;
+	}
+
+	h ^= h >> 13;
+	h *= m;
+	h ^= h >> 15;
+	return h;
+}
+
+}
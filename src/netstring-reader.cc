@@ -48,6 +48,12 @@ bool Reader::parse(std::string & str)
 	}
 }
 
+void Reader::reset()
+{
+	state_ = State::start;
+	len_ = 0;
+}
+
 bool Reader::parse_length()
 {
 	for (;;) {
@@ -65,7 +71,7 @@ bool Reader::parse_length()
 		case IO::StreamBuffer::End:
 			return false;
 		}
-		throw std::runtime_error(Fmt::format("unexpected character '%s' while parsing length", char(c)));
+		throw std::runtime_error(FMT_FORMAT("unexpected character '%s' while parsing length", char(c)));
 	}
 }
 
@@ -84,7 +90,7 @@ bool Reader::parse_delim()
 	case IO::StreamBuffer::End:
 		throw std::runtime_error("unexpected buffer end");
 	default:
-		throw std::runtime_error(Fmt::format("unexpected character '%s' while parsing delimiter", char(c)));
+		throw std::runtime_error(FMT_FORMAT("unexpected character '%s' while parsing delimiter", char(c)));
 	}
 	return false;
 }
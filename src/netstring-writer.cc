@@ -0,0 +1,28 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "netstring/writer.h"
+#include "io/buffer.h"
+
+#include <string>
+
+namespace Netstring {
+
+void write(IO::WriteBuffer & buf, std::string_view const& str)
+{
+	auto len = std::to_string(str.size());
+	auto size = len.size() + 1 + str.size() + 1;
+
+	buf.reserve(size);
+	auto *p = static_cast<char *>(buf.wstart());
+	p += len.copy(p, len.size());
+	*p++ = ':';
+	p += str.copy(p, str.size());
+	*p = ',';
+	buf.fill(size);
+}
+
+}
@@ -69,7 +69,7 @@ std::shared_ptr<CharDev> CharDevFactoryImpl::make_chardev(std::string const& pat
 {
 	auto fd = ::open(path.c_str(), O_CLOEXEC|O_NONBLOCK|O_RDWR);
 	if (fd == -1) {
-		throw make_system_error(errno, Fmt::format("::open(%s, O_CLOEXEC|O_NONBLOCK|O_RDWR);", path.c_str()));
+		throw make_system_error(errno, FMT_FORMAT("::open(%s, O_CLOEXEC|O_NONBLOCK|O_RDWR);", path.c_str()));
 	}
 	return std::make_shared<CharDevImpl>(Fd::create(fd));
 }
@@ -6,12 +6,19 @@
 
 #include "posix/pid.h"
 
+#include "posix/fd.h"
 #include "posix/signal.h"
 #include "posix/system-error.h"
 #include "posix/wait.h"
 
 #include <signal.h>
+#include <spawn.h>
+#include <stdexcept>
+#include <sys/syscall.h>
 #include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
 
 namespace Posix {
 
@@ -24,18 +31,99 @@ public:
 		static_assert(std::is_same_v<pid_t, int>);
 	}
 
+	int get() const override
+	{
+		return value_;
+	}
+
 	void kill(Signal) override;
 	Wait::Status wait(Wait::Option) override;
+	std::shared_ptr<Fd> fd() override;
 
 private:
 	pid_t value_ = -1;
+	std::shared_ptr<Fd> fd_;
+};
+
+namespace {
+
+// The child starts with no blocked signals and default dispositions,
+// whatever the parent blocked or ignored for its own signal handling.
+class SpawnAttr {
+public:
+	SpawnAttr()
+	{
+		auto err = ::posix_spawnattr_init(&attr_);
+		if (err != 0) {
+			throw make_system_error(err, "::posix_spawnattr_init(%x)", &attr_);
+		}
+
+		try {
+			sigset_t set;
+			::sigemptyset(&set);
+			check(::posix_spawnattr_setsigmask(&attr_, &set), "posix_spawnattr_setsigmask");
+			::sigfillset(&set);
+			check(::posix_spawnattr_setsigdefault(&attr_, &set), "posix_spawnattr_setsigdefault");
+			check(::posix_spawnattr_setflags(&attr_, POSIX_SPAWN_SETSIGMASK|POSIX_SPAWN_SETSIGDEF),
+				"posix_spawnattr_setflags");
+		} catch (...) {
+			::posix_spawnattr_destroy(&attr_);
+			throw;
+		}
+	}
+
+	SpawnAttr(SpawnAttr const&) = delete;
+	SpawnAttr & operator=(SpawnAttr const&) = delete;
+
+	~SpawnAttr()
+	{
+		::posix_spawnattr_destroy(&attr_);
+	}
+
+	posix_spawnattr_t const* get() const
+	{
+		return &attr_;
+	}
+
+private:
+	void check(int err, char const* what)
+	{
+		if (err != 0) {
+			throw make_system_error(err, "::%s(%x)", what, &attr_);
+		}
+	}
+
+	posix_spawnattr_t attr_;
 };
 
+}
+
 std::shared_ptr<Pid> Pid::create(int value)
 {
 	return std::make_shared<PidImpl>(value);
 }
 
+std::shared_ptr<Pid> Pid::spawn(std::vector<std::string> const& args)
+{
+	if (args.empty()) {
+		throw std::runtime_error("Pid::spawn: empty argument list");
+	}
+
+	auto argv = std::vector<char *>{};
+	for (auto const& arg : args) {
+		argv.push_back(const_cast<char *>(arg.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	auto attr = SpawnAttr{};
+	pid_t pid{-1};
+	auto err = ::posix_spawnp(&pid, argv[0], nullptr, attr.get(), argv.data(), environ);
+	if (err != 0) {
+		throw make_system_error(err, "::posix_spawnp(%x, %s, nullptr, %x, %x, %x)", &pid, args[0], attr.get(), argv.data(), environ);
+	}
+	return create(pid);
+}
+
 void PidImpl::kill(Signal sig)
 {
 	auto res = ::kill(value_, static_cast<int>(sig));
@@ -63,4 +151,18 @@ Wait::Status PidImpl::wait(Wait::Option opt)
 	return Wait::Status{status};
 }
 
+std::shared_ptr<Fd> PidImpl::fd()
+{
+	if (fd_) {
+		return fd_;
+	}
+
+	auto fd = ::syscall(SYS_pidfd_open, value_, 0);
+	if (fd == -1) {
+		throw make_system_error(errno, "::pidfd_open(%s, 0)", value_);
+	}
+	fd_ = Fd::create(fd);
+	return fd_;
+}
+
 }
@@ -4,6 +4,8 @@
    license that can be found in the LICENSE file.
 */
 
+#include <array>
+
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -47,7 +49,7 @@ Pipe PipeFactoryImpl::make_pipe(Params const& params) const
 	auto pipefd = std::array<int, 2>{-1, -1};
 	auto res = ::pipe2(pipefd.data(), pipe_params(params));
 	if (res == -1) {
-		throw make_system_error(errno, Fmt::format("::pipe2(%x, %s);",
+		throw make_system_error(errno, FMT_FORMAT("::pipe2(%x, %s);",
 				pipefd.data(), pipe_params(params)));
 	}
 	return {Fd::create(pipefd[0]), Fd::create(pipefd[1])};
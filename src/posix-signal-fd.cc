@@ -0,0 +1,145 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "posix/signal-fd.h"
+#include "posix/signal.h"
+#include "posix/system-error.h"
+
+#include <array>
+#include <cassert>
+#include <csignal>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+namespace Posix {
+
+class SignalFdImpl : public SignalFd {
+public:
+	SignalFdImpl(std::shared_ptr<Fd> const&, sigset_t const&);
+	~SignalFdImpl();
+
+	size_t read_signals(SignalInfo *, size_t) const override;
+
+	int get() const override
+	{
+		return fd_->get();
+	}
+
+	size_t write(void const* buf, size_t count) const override
+	{
+		return fd_->write(buf, count);
+	}
+
+	size_t read(void *buf, size_t count) const override
+	{
+		return fd_->read(buf, count);
+	}
+
+private:
+	std::shared_ptr<Fd> fd_;
+	sigset_t unblock_;
+};
+
+SignalFdImpl::SignalFdImpl(std::shared_ptr<Fd> const& fd, sigset_t const& unblock)
+:
+	fd_(fd),
+	unblock_(unblock)
+{ }
+
+SignalFdImpl::~SignalFdImpl()
+{
+	::pthread_sigmask(SIG_UNBLOCK, &unblock_, nullptr);
+}
+
+size_t SignalFdImpl::read_signals(SignalInfo *info, size_t count) const
+{
+	auto buf = std::array<signalfd_siginfo, 16>{};
+	count = std::min(count, buf.size());
+
+	ssize_t res{-1};
+	do {
+		res = ::read(fd_->get(), buf.data(), count * sizeof(signalfd_siginfo));
+	} while (res == -1 && errno == EINTR);
+
+	if (res == -1) {
+		if (errno == EAGAIN) {
+			return 0;
+		}
+		throw POSIX_SYSTEM_ERROR("::read(%s, %x, %s)", fd_->get(), buf.data(), count * sizeof(signalfd_siginfo));
+	}
+
+	assert(res % sizeof(signalfd_siginfo) == 0);
+	auto nsignals = size_t(res) / sizeof(signalfd_siginfo);
+	for (size_t n{0}; n < nsignals; ++n) {
+		info[n].signo = static_cast<Signal>(buf[n].ssi_signo);
+		info[n].code = buf[n].ssi_code;
+		info[n].pid = buf[n].ssi_pid;
+		info[n].uid = buf[n].ssi_uid;
+		info[n].status = buf[n].ssi_status;
+	}
+	return nsignals;
+}
+
+class SignalFdFactoryImpl : public SignalFdFactory {
+public:
+	std::shared_ptr<SignalFd> make_signalfd(std::vector<Signal> const&, Fd::Options const&) const override;
+};
+
+std::unique_ptr<SignalFdFactory> SignalFdFactory::create()
+{
+	return std::make_unique<SignalFdFactoryImpl>();
+}
+
+namespace {
+
+int signalfd_flags(Fd::Options const& options)
+{
+	int res{0};
+	if (options & Fd::Option::nonblock) {
+		res |= SFD_NONBLOCK;
+	}
+	if (options & Fd::Option::cloexec) {
+		res |= SFD_CLOEXEC;
+	}
+	return res;
+}
+
+}
+
+std::shared_ptr<SignalFd> SignalFdFactoryImpl::make_signalfd(std::vector<Signal> const& signals, Fd::Options const& options) const
+{
+	sigset_t mask;
+	::sigemptyset(&mask);
+	for (auto sig : signals) {
+		::sigaddset(&mask, static_cast<int>(sig));
+	}
+
+	sigset_t old;
+	auto err = ::pthread_sigmask(SIG_BLOCK, &mask, &old);
+	if (err != 0) {
+		throw make_system_error(err, "::pthread_sigmask(SIG_BLOCK, %x, %x)", &mask, &old);
+	}
+
+	// only unblock what was not blocked before
+	sigset_t unblock;
+	::sigemptyset(&unblock);
+	for (auto sig : signals) {
+		if (!::sigismember(&old, static_cast<int>(sig))) {
+			::sigaddset(&unblock, static_cast<int>(sig));
+		}
+	}
+
+	auto fd = ::signalfd(-1, &mask, signalfd_flags(options));
+	if (fd == -1) {
+		auto ec = errno;
+		::pthread_sigmask(SIG_UNBLOCK, &unblock, nullptr);
+		throw make_system_error(ec, "::signalfd(-1, %x, %s)", &mask, signalfd_flags(options));
+	}
+
+	return std::make_shared<SignalFdImpl>(Fd::create(fd), unblock);
+}
+
+}
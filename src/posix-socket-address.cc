@@ -5,13 +5,16 @@
 */
 
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
+#include <cstddef>
 #include <cstring>
 #include <utility>
 #include <stdexcept>
 
 #include "posix/socket-address.h"
 #include "posix/inet-address.h"
+#include "posix/unix-address.h"
 
 bool operator<(sockaddr_storage const& l, sockaddr_storage const& r)
 {
@@ -36,6 +39,36 @@ size_t init_sockaddr_inet6(sockaddr_in6 *sockaddr, uint16_t port, in6_addr const
 	return sizeof(sockaddr_in6);
 }
 
+size_t init_sockaddr_unix(sockaddr_un *sockaddr, Posix::Unix::Address const& addr)
+{
+	auto const& path = addr.path();
+	if (path.size() >= sizeof(sockaddr->sun_path)) {
+		throw std::runtime_error("unix socket path too long: " + path);
+	}
+
+	sockaddr->sun_family = AF_UNIX;
+	path.copy(sockaddr->sun_path, path.size());
+	if (addr.abstract()) {
+		// abstract names are not nul terminated, the length is
+		// given by the address size only
+		sockaddr->sun_path[0] = '\0';
+		return offsetof(sockaddr_un, sun_path) + path.size();
+	}
+	return offsetof(sockaddr_un, sun_path) + path.size() + 1;
+}
+
+std::string unix_path(sockaddr_un const* sockaddr, size_t size)
+{
+	auto len = size - offsetof(sockaddr_un, sun_path);
+	if (len == 0) {
+		return {};
+	}
+	if (sockaddr->sun_path[0] == '\0') {
+		return '@' + std::string{sockaddr->sun_path + 1, len - 1};
+	}
+	return {sockaddr->sun_path, ::strnlen(sockaddr->sun_path, len)};
+}
+
 }
 
 namespace Posix {
@@ -63,6 +96,16 @@ SocketAddress::SocketAddress(Inet::Address const& addr, uint16_t port)
 	}
 }
 
+SocketAddress::SocketAddress(Unix::Address const& addr)
+:
+	data_{std::make_unique<sockaddr_storage>()}
+{
+	if (!addr) {
+		throw std::runtime_error("Can't create SocketAddress from empty unix socket path");
+	}
+	size_ = ::init_sockaddr_unix(reinterpret_cast<sockaddr_un*>(data_.get()), addr);
+}
+
 SocketAddress::~SocketAddress() = default;
 SocketAddress::SocketAddress() = default;
 
@@ -96,6 +139,11 @@ SocketAddress & SocketAddress::operator=(SocketAddress && o)
 	return *this;
 }
 
+int SocketAddress::family() const
+{
+	return size_ == 0 ? AF_UNSPEC : data_->ss_family;
+}
+
 bool operator<(SocketAddress const& l, SocketAddress const& r)
 {
 	return !(l.size_ == 0 && r.size_ == 0) && std::tie(l.size_, *l.data_) < std::tie(r.size_, *r.data_);
@@ -110,6 +158,8 @@ std::string to_string(SocketAddress const& addr)
 	auto addrstr = std::string{};
 	auto port = uint16_t{0};
 	switch (addr.data_->ss_family) {
+	case AF_UNIX:
+		return ::unix_path(reinterpret_cast<sockaddr_un const*>(addr.data_.get()), addr.size_);
 	case AF_INET:
 		addrstr = to_string(Inet::Address{&addr.getSockaddrIn()->sin_addr});
 		port = ::ntohs(addr.getSockaddrIn()->sin_port);
@@ -124,4 +174,33 @@ std::string to_string(SocketAddress const& addr)
 	return addrstr + ':' + std::to_string(port);
 }
 
+SocketAddress parse_socket_address(std::string const& str)
+{
+	if (str.empty()) {
+		throw std::runtime_error("empty socket address");
+	}
+
+	if (str[0] == '/' || str[0] == '@' || str[0] == '.') {
+		return SocketAddress{Unix::Address{str}};
+	}
+
+	auto sep = str.rfind(':');
+	if (sep == std::string::npos || sep + 1 == str.size()) {
+		throw std::runtime_error("missing port in socket address: " + str);
+	}
+
+	auto host = str.substr(0, sep);
+	if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+		host = host.substr(1, host.size() - 2);
+	}
+
+	size_t end{0};
+	auto port = std::stoul(str.substr(sep + 1), &end);
+	if (end != str.size() - sep - 1 || port > 0xffff) {
+		throw std::runtime_error("invalid port in socket address: " + str);
+	}
+
+	return SocketAddress{Inet::Address{host}, uint16_t(port)};
+}
+
 }
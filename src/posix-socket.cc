@@ -6,6 +6,8 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 
 #include "posix/socket.h"
 #include "posix/socket-address.h"
@@ -20,8 +22,11 @@ public:
 
 	void bind(SocketAddress const&) const override;
 	void connect(SocketAddress const&) const override;
+	void listen(int) const override;
+	std::shared_ptr<Socket> accept(Fd::Options const&) const override;
 	std::error_code get_socket_error() const override;
 	void set_recvbuf(size_t) const override;
+	void set_nodelay(bool) const override;
 
 	int get() const override
 	{
@@ -54,7 +59,7 @@ void SocketImpl::bind(SocketAddress const& addr) const
 {
 	auto res = ::bind(fd_->get(), addr.getSockaddr(), addr.size());
 	if (res == -1) {
-		throw POSIX_SYSTEM_ERROR("::bind(fd.get(), addr.data(), addr.size());", fd_.get(), addr.getSockaddr(), addr.size());
+		throw POSIX_SYSTEM_ERROR("::bind(%s, %s, %s);", fd_->get(), addr.getSockaddr(), addr.size());
 	}
 }
 
@@ -70,6 +75,34 @@ void SocketImpl::connect(SocketAddress const& addr) const
 	}
 }
 
+void SocketImpl::listen(int backlog) const
+{
+	if (::listen(fd_->get(), backlog) == -1) {
+		throw POSIX_SYSTEM_ERROR("::listen(%s, %s);", fd_->get(), backlog);
+	}
+}
+
+std::shared_ptr<Socket> SocketImpl::accept(Fd::Options const& options) const
+{
+	int flags{0};
+	if (options & Fd::Option::nonblock) {
+		flags |= SOCK_NONBLOCK;
+	}
+	if (options & Fd::Option::cloexec) {
+		flags |= SOCK_CLOEXEC;
+	}
+
+	int res{-1};
+	do {
+		res = ::accept4(fd_->get(), nullptr, nullptr, flags);
+	} while (res == -1 && errno == EINTR);
+
+	if (res == -1) {
+		throw POSIX_SYSTEM_ERROR("::accept4(%s, nullptr, nullptr, %s);", fd_->get(), flags);
+	}
+	return std::make_shared<SocketImpl>(Fd::create(res));
+}
+
 int SocketImpl::getsockopt(int level, int optname) const
 {
 	int value{0};
@@ -99,6 +132,11 @@ void SocketImpl::set_recvbuf(size_t size) const
 	setsockopt(SOL_SOCKET, SO_RCVBUF, size);
 }
 
+void SocketImpl::set_nodelay(bool on) const
+{
+	setsockopt(IPPROTO_TCP, TCP_NODELAY, on);
+}
+
 class StreamSocketImpl : public StreamSocket {
 public:
 	explicit StreamSocketImpl(std::shared_ptr<Socket> const& socket)
@@ -141,6 +179,21 @@ public:
 		return socket_->set_recvbuf(size);
 	}
 
+	void set_nodelay(bool on) const override
+	{
+		socket_->set_nodelay(on);
+	}
+
+	void listen(int backlog) const override
+	{
+		socket_->listen(backlog);
+	}
+
+	std::shared_ptr<Socket> accept(Fd::Options const& options) const override
+	{
+		return socket_->accept(options);
+	}
+
 	void connect(SocketAddress const& addr) const override
 	{
 		try {
@@ -232,7 +285,7 @@ std::shared_ptr<Socket> SocketFactoryImpl::make_socket(std::tuple<int, int, int>
 
 	auto fd = ::socket(std::get<0>(call_params), std::get<1>(call_params), std::get<2>(call_params));
 	if (fd == -1) {
-		throw make_system_error(errno, Fmt::format("::socket(%s, %s, %s);",
+		throw make_system_error(errno, FMT_FORMAT("::socket(%s, %s, %s);",
 					std::get<0>(call_params), std::get<1>(call_params), std::get<2>(call_params)));
 	}
 	return std::make_shared<SocketImpl>(Fd::create(fd));
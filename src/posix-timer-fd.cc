@@ -0,0 +1,120 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "posix/timer-fd.h"
+#include "posix/system-error.h"
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace Posix {
+
+class TimerFdImpl : public TimerFd {
+public:
+	explicit TimerFdImpl(std::shared_ptr<Fd> const& fd)
+	:
+		fd_(fd)
+	{ }
+
+	void set(std::chrono::nanoseconds const&, std::chrono::nanoseconds const&) const override;
+	void cancel() const override;
+	uint64_t expirations() const override;
+
+	int get() const override
+	{
+		return fd_->get();
+	}
+
+	size_t write(void const* buf, size_t count) const override
+	{
+		return fd_->write(buf, count);
+	}
+
+	size_t read(void *buf, size_t count) const override
+	{
+		return fd_->read(buf, count);
+	}
+
+private:
+	void settime(itimerspec const&) const;
+
+	std::shared_ptr<Fd> fd_;
+};
+
+namespace {
+
+timespec to_timespec(std::chrono::nanoseconds const& ns)
+{
+	auto sec = std::chrono::duration_cast<std::chrono::seconds>(ns);
+	return {static_cast<time_t>(sec.count()), static_cast<long>((ns - sec).count())};
+}
+
+}
+
+void TimerFdImpl::set(std::chrono::nanoseconds const& value, std::chrono::nanoseconds const& interval) const
+{
+	// a zero it_value would disarm the timer
+	auto spec = itimerspec{to_timespec(interval), to_timespec(std::max(value, std::chrono::nanoseconds(1)))};
+	settime(spec);
+}
+
+void TimerFdImpl::cancel() const
+{
+	settime(itimerspec{});
+}
+
+void TimerFdImpl::settime(itimerspec const& spec) const
+{
+	if (::timerfd_settime(fd_->get(), 0, &spec, nullptr) == -1) {
+		throw POSIX_SYSTEM_ERROR("::timerfd_settime(%s, 0, %x, nullptr)", fd_->get(), &spec);
+	}
+}
+
+uint64_t TimerFdImpl::expirations() const
+{
+	uint64_t res{0};
+	ssize_t size{-1};
+	do {
+		size = ::read(fd_->get(), &res, sizeof(res));
+	} while (size == -1 && errno == EINTR);
+
+	if (size == -1) {
+		if (errno == EAGAIN) {
+			return 0;
+		}
+		throw POSIX_SYSTEM_ERROR("::read(%s, %x, %s)", fd_->get(), &res, sizeof(res));
+	}
+	return res;
+}
+
+class TimerFdFactoryImpl : public TimerFdFactory {
+public:
+	std::shared_ptr<TimerFd> make_timerfd(Fd::Options const&) const override;
+};
+
+std::unique_ptr<TimerFdFactory> TimerFdFactory::create()
+{
+	return std::make_unique<TimerFdFactoryImpl>();
+}
+
+std::shared_ptr<TimerFd> TimerFdFactoryImpl::make_timerfd(Fd::Options const& options) const
+{
+	int flags{0};
+	if (options & Fd::Option::nonblock) {
+		flags |= TFD_NONBLOCK;
+	}
+	if (options & Fd::Option::cloexec) {
+		flags |= TFD_CLOEXEC;
+	}
+
+	auto fd = ::timerfd_create(CLOCK_MONOTONIC, flags);
+	if (fd == -1) {
+		throw POSIX_SYSTEM_ERROR("::timerfd_create(CLOCK_MONOTONIC, %s)", flags);
+	}
+	return std::make_shared<TimerFdImpl>(Fd::create(fd));
+}
+
+}
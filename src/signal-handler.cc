@@ -0,0 +1,57 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "signal-handler.h"
+
+#include "posix/signal.h"
+#include "fmt.h"
+
+#include <array>
+
+SignalHandler::SignalHandler(
+	EPoll::Ctrl & poller,
+	Posix::SignalFdFactory & signalfd_factory,
+	std::vector<Posix::Signal> const& signals)
+:
+	fd_(signalfd_factory.make_signalfd(signals, Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec)),
+	poller_(poller)
+{
+	for (auto sig : signals) {
+		on_signal_[sig];
+	}
+
+	poller_.add(fd_, EPoll::Events{EPoll::Event::In}, [this] (auto const& ev) {
+		if (ev != EPoll::Event::In) {
+			throw std::runtime_error("bad epoll event on signalfd");
+		}
+		on_readable();
+	});
+}
+
+SignalHandler::~SignalHandler()
+{
+	poller_.del(fd_);
+}
+
+SignalProxy<void(Posix::Signal, Posix::SignalInfo const&)> & SignalHandler::on_signal(Posix::Signal sig)
+{
+	auto it = on_signal_.find(sig);
+	if (it == on_signal_.end()) {
+		throw std::runtime_error(FMT_FORMAT("signal %s is not handled", to_string(sig)));
+	}
+	return it->second;
+}
+
+void SignalHandler::on_readable()
+{
+	auto info = std::array<Posix::SignalInfo, 16>{};
+	auto count = fd_->read_signals(info.data(), info.size());
+	for (size_t n{0}; n < count; ++n) {
+		auto it = on_signal_.find(info[n].signo);
+		if (it != on_signal_.end()) {
+			it->second(info[n].signo, info[n]);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "epoll/ctrl.h"
+#include "posix/signal-fd.h"
+#include "signals.h"
+
+namespace Posix {
+enum class Signal;
+}
+
+// Receives the given signals through a signalfd registered with the
+// event loop. All signals pending at wakeup are read with a single
+// read(2) and delivered in order.
+class SignalHandler {
+public:
+	SignalHandler(
+		EPoll::Ctrl &,
+		Posix::SignalFdFactory &,
+		std::vector<Posix::Signal> const&);
+
+	SignalHandler(SignalHandler const&) = delete;
+	SignalHandler & operator=(SignalHandler const&) = delete;
+
+	~SignalHandler();
+
+	SignalProxy<void(Posix::Signal, Posix::SignalInfo const&)> & on_signal(Posix::Signal);
+
+private:
+	void on_readable();
+
+	std::map<Posix::Signal, Signal<void(Posix::Signal, Posix::SignalInfo const&)>> on_signal_;
+	std::shared_ptr<Posix::SignalFd> fd_;
+	EPoll::Ctrl & poller_;
+};
@@ -493,6 +493,68 @@ UTEST_CASE_WITH_FIXTURE(multiple_events_one_send_test, EventTestFixture)
 	UTEST_ASSERT_EQUAL(size_t(4096), recvbuf.wsize());
 }
 
+UTEST_CASE_WITH_FIXTURE(send_test, CommandTestFixture)
+{
+	auto token = ctrl->send({"dial", "sip:7777@asterisk.example.com", ""});
+	UTEST_ASSERT_EQUAL(std::string("cl-1"), token);
+	UTEST_ASSERT_EQUAL(to_netstring("{\"command\": \"dial\", \"params\": \"sip:7777@asterisk.example.com\", \"token\": \"cl-1\"}"),
+		std::string(static_cast<char *>(sendbuf.rstart()), sendbuf.rsize()));
+
+	sendbuf.drain(sendbuf.rsize());
+	ctrl->send({"hangup", "", "my-token"});
+	UTEST_ASSERT_EQUAL(to_netstring("{\"command\": \"hangup\", \"token\": \"my-token\"}"),
+		std::string(static_cast<char *>(sendbuf.rstart()), sendbuf.rsize()));
+	UTEST_ASSERT_THROW(ctrl->send({"hangup", "", "my-token"}), std::runtime_error);
+}
+
+UTEST_CASE_WITH_FIXTURE(token_collision_test, CommandTestFixture)
+{
+	// caller tokens never clash with generated ones
+	UTEST_ASSERT_EQUAL(std::string("1"), ctrl->send({"accept", "", "1"}));
+	UTEST_ASSERT_EQUAL(std::string("cl-1"), ctrl->send({"hangup", "", ""}));
+
+	// unless a caller picks from the generated range
+	UTEST_ASSERT_EQUAL(std::string("cl-3"), ctrl->send({"accept", "", "cl-3"}));
+	UTEST_ASSERT_EQUAL(std::string("cl-2"), ctrl->send({"hangup", "", ""}));
+	UTEST_ASSERT_EQUAL(std::string("cl-4"), ctrl->send({"hangup", "", ""}));
+	UTEST_ASSERT_EQUAL(size_t(5), ctrl->pending());
+}
+
+UTEST_CASE_WITH_FIXTURE(pipelined_send_test, CommandTestFixture)
+{
+	auto completed = std::vector<std::string>{};
+	auto tokens = std::vector<std::string>{};
+	for (auto cmd : {"accept", "hangup", "dial"}) {
+		tokens.push_back(ctrl->send({cmd, "", ""}, [&completed] (auto const& resp) {
+			completed.push_back(resp.token);
+		}));
+	}
+	UTEST_ASSERT_EQUAL(size_t(3), ctrl->pending());
+
+	// responses may arrive in any order
+	for (auto i : {2, 0, 1}) {
+		send_data("{\"response\":true,\"ok\":true,\"data\":\"\",\"token\":\"" + tokens[i] + "\"}");
+	}
+	UTEST_ASSERT_EQUAL(size_t(0), ctrl->pending());
+	UTEST_ASSERT_EQUAL(size_t(3), completed.size());
+	UTEST_ASSERT_EQUAL(tokens[2], completed[0]);
+	UTEST_ASSERT_EQUAL(tokens[0], completed[1]);
+	UTEST_ASSERT_EQUAL(tokens[1], completed[2]);
+	UTEST_ASSERT(have_res);
+}
+
+UTEST_CASE_WITH_FIXTURE(reset_pending_test, CommandTestFixture)
+{
+	auto failed = size_t{0};
+	ctrl->send({"dial", "sip:7777@asterisk.example.com", ""}, [&failed] (auto const& resp) {
+		UTEST_ASSERT(!resp.ok);
+		++failed;
+	});
+	ctrl->reset();
+	UTEST_ASSERT_EQUAL(size_t(1), failed);
+	UTEST_ASSERT_EQUAL(size_t(0), ctrl->pending());
+}
+
 /*
 
 {"event":true,"type":"EXIT","class":"application"},
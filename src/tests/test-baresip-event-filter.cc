@@ -0,0 +1,91 @@
+#include "utest/macros.h"
+#include "baresip/event-filter.h"
+
+#include <vector>
+
+namespace unittests {
+namespace baresip_event_filter {
+
+class Fixture {
+public:
+	Fixture()
+	:
+		filter(Baresip::EventFilter::create())
+	{
+		filter->on_forward.connect([this](auto const& ev) { forwarded.push_back(ev); });
+	}
+
+	static Baresip::Event::Any call_event(Baresip::Event::Call::Type type, std::string const& id)
+	{
+		return Baresip::Event::Any{Baresip::Event::Call{
+			type,
+			"sip:9999-1@asterisk.example.com",
+			Baresip::Event::Call::Direction::Incoming,
+			"sip:7777@asterisk.example.com",
+			id,
+			""}};
+	}
+
+	static Baresip::Event::Any register_event(Baresip::Event::Register::Type type, std::string const& aor)
+	{
+		return Baresip::Event::Any{Baresip::Event::Register{type, aor, ""}};
+	}
+
+	std::unique_ptr<Baresip::EventFilter> filter;
+	std::vector<Baresip::Event::Any> forwarded;
+};
+
+UTEST_CASE_WITH_FIXTURE(call_test, Fixture)
+{
+	filter->on_event(call_event(Baresip::Event::Call::Type::Ringing, "1"));
+	filter->on_event(call_event(Baresip::Event::Call::Type::Ringing, "1"));
+	filter->on_event(call_event(Baresip::Event::Call::Type::Ringing, "2"));
+	filter->on_event(call_event(Baresip::Event::Call::Type::Ringing, "1"));
+	UTEST_ASSERT_EQUAL(size_t(2), forwarded.size());
+
+	filter->on_event(call_event(Baresip::Event::Call::Type::Established, "1"));
+	filter->on_event(call_event(Baresip::Event::Call::Type::Closed, "1"));
+	UTEST_ASSERT_EQUAL(size_t(4), forwarded.size());
+
+	// a closed id starts a new call
+	filter->on_event(call_event(Baresip::Event::Call::Type::Ringing, "1"));
+	UTEST_ASSERT_EQUAL(size_t(5), forwarded.size());
+
+	UTEST_ASSERT_EQUAL(uint64_t(5), filter->stats().forwarded);
+	UTEST_ASSERT_EQUAL(uint64_t(2), filter->stats().suppressed);
+}
+
+UTEST_CASE_WITH_FIXTURE(register_test, Fixture)
+{
+	filter->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:1@example.com"));
+	filter->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:1@example.com"));
+	filter->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:2@example.com"));
+	filter->on_event(register_event(Baresip::Event::Register::Type::Fail, "sip:1@example.com"));
+	filter->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:1@example.com"));
+	UTEST_ASSERT_EQUAL(size_t(4), forwarded.size());
+	UTEST_ASSERT_EQUAL(uint64_t(1), filter->stats().suppressed);
+}
+
+UTEST_CASE_WITH_FIXTURE(reset_test, Fixture)
+{
+	filter->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:1@example.com"));
+	filter->on_event(call_event(Baresip::Event::Call::Type::Ringing, "1"));
+	filter->reset();
+	filter->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:1@example.com"));
+	filter->on_event(call_event(Baresip::Event::Call::Type::Ringing, "1"));
+	UTEST_ASSERT_EQUAL(size_t(4), forwarded.size());
+	UTEST_ASSERT_EQUAL(uint64_t(0), filter->stats().suppressed);
+}
+
+UTEST_CASE_WITH_FIXTURE(pass_test, Fixture)
+{
+	UTEST_ASSERT(filter->pass(call_event(Baresip::Event::Call::Type::Ringing, "1")));
+	UTEST_ASSERT(!filter->pass(call_event(Baresip::Event::Call::Type::Ringing, "1")));
+
+	// pass() leaves forwarding to the caller
+	UTEST_ASSERT(forwarded.empty());
+	UTEST_ASSERT_EQUAL(uint64_t(1), filter->stats().forwarded);
+	UTEST_ASSERT_EQUAL(uint64_t(1), filter->stats().suppressed);
+}
+
+}}
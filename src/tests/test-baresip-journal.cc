@@ -0,0 +1,100 @@
+#include "utest/macros.h"
+#include "baresip/journal.h"
+#include "posix/fd.h"
+#include "posix/pipe-factory.h"
+
+#include <array>
+#include <tuple>
+
+namespace unittests {
+namespace baresip_journal {
+
+std::string read_all(Posix::Fd const& fd)
+{
+	auto res = std::string{};
+	auto buf = std::array<char, 1024>{};
+	while (auto size = fd.read(buf.data(), buf.size())) {
+		res.append(buf.data(), size);
+	}
+	return res;
+}
+
+UTEST_CASE(write_read_test)
+{
+	auto [rfd, wfd] = Posix::PipeFactory::create()->make_pipe({});
+
+	auto call = Baresip::Event::Call{
+		Baresip::Event::Call::Type::Ringing,
+		"sip:9999-1@asterisk.example.com",
+		Baresip::Event::Call::Direction::Outgoing,
+		"sip:7777@asterisk.example.com;transport=udp",
+		"6d42101ce49915a3",
+		"sip:7777@asterisk.example.com;transport=udp"};
+	auto reg = Baresip::Event::Register{
+		Baresip::Event::Register::Type::Fail,
+		"sip:9999-1@asterisk.example.com",
+		std::string(300, 'x')};
+
+	{
+		auto writer = Baresip::Journal::Writer(wfd);
+		writer.write(Baresip::Journal::Record{std::chrono::nanoseconds(1000), call});
+		writer.write(Baresip::Journal::Record{std::chrono::nanoseconds(5000), reg});
+		wfd.reset();
+	}
+
+	auto data = read_all(*rfd);
+	auto reader = Baresip::Journal::Reader(data);
+	auto record = Baresip::Journal::Record{};
+
+	UTEST_ASSERT(reader.next(record));
+	UTEST_ASSERT(std::chrono::nanoseconds(1000) == record.time);
+	auto const& c = std::get<Baresip::Event::Call>(record.event);
+	UTEST_ASSERT(c.type == call.type);
+	UTEST_ASSERT(c.accountaor == call.accountaor);
+	UTEST_ASSERT(c.direction == call.direction);
+	UTEST_ASSERT(c.peeruri == call.peeruri);
+	UTEST_ASSERT_EQUAL(call.id, c.id);
+	UTEST_ASSERT_EQUAL(call.param, c.param);
+
+	UTEST_ASSERT(reader.next(record));
+	UTEST_ASSERT(std::chrono::nanoseconds(5000) == record.time);
+	auto const& r = std::get<Baresip::Event::Register>(record.event);
+	UTEST_ASSERT(r.type == reg.type);
+	UTEST_ASSERT(r.accountaor == reg.accountaor);
+	UTEST_ASSERT_EQUAL(reg.param, r.param);
+
+	UTEST_ASSERT(!reader.next(record));
+}
+
+UTEST_CASE(bad_data_test)
+{
+	UTEST_ASSERT_THROW(Baresip::Journal::Reader(""), std::runtime_error);
+	UTEST_ASSERT_THROW(Baresip::Journal::Reader("XXXX"), std::runtime_error);
+
+	auto record = Baresip::Journal::Record{};
+
+	// record size beyond the end of the data
+	auto truncated = std::string{Baresip::Journal::Magic} + std::string("\x05\x00\x01", 3);
+	auto reader = Baresip::Journal::Reader(truncated);
+	UTEST_ASSERT_THROW(reader.next(record), std::runtime_error);
+
+	// unknown event type
+	auto unknown = std::string{Baresip::Journal::Magic} + std::string("\x02\x00\x07", 3);
+	reader = Baresip::Journal::Reader(unknown);
+	UTEST_ASSERT_THROW(reader.next(record), std::runtime_error);
+
+	// a register event with a time using all ten varint bytes ...
+	auto max = std::string{Baresip::Journal::Magic} + std::string("\x0e") +
+		std::string(9, '\x80') + std::string("\x01\x00\x00\x00\x00", 5);
+	reader = Baresip::Journal::Reader(max);
+	UTEST_ASSERT(reader.next(record));
+	UTEST_ASSERT(std::chrono::nanoseconds(uint64_t(1) << 63) == record.time);
+
+	// ... bits beyond 63 are an error, not dropped
+	auto overflow = std::string{Baresip::Journal::Magic} + std::string("\x0e") +
+		std::string(9, '\x80') + std::string("\x02\x00\x00\x00\x00", 5);
+	reader = Baresip::Journal::Reader(overflow);
+	UTEST_ASSERT_THROW(reader.next(record), std::runtime_error);
+}
+
+}}
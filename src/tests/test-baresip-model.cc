@@ -51,6 +51,23 @@ public:
 		model(Baresip::Model::create())
 	{ }
 
+	static Baresip::Event::Any call_event(Baresip::Event::Call::Type type, std::string const& id,
+		Baresip::Event::Call::Direction direction = Baresip::Event::Call::Direction::Incoming)
+	{
+		return Baresip::Event::Any{Baresip::Event::Call{
+			type,
+			"sip:9999-1@asterisk.example.com",
+			direction,
+			"sip:7777@asterisk.example.com;transport=udp",
+			id,
+			""}};
+	}
+
+	static Baresip::Event::Any register_event(Baresip::Event::Register::Type type, std::string const& aor)
+	{
+		return Baresip::Event::Any{Baresip::Event::Register{type, aor, ""}};
+	}
+
 	std::unique_ptr<Baresip::Model> model;
 };
 
@@ -172,6 +189,59 @@ UTEST_CASE_WITH_FIXTURE(outgoing_call_test, Fixture)
 	UTEST_ASSERT_EQUAL(Baresip::Call::State::Closed, call->state());
 }
 
+UTEST_CASE_WITH_FIXTURE(call_history_test, Fixture)
+{
+	auto ncalls = Baresip::Model::HistorySize + 4;
+	for (size_t n{0}; n < ncalls; ++n) {
+		model->on_event(call_event(Baresip::Event::Call::Type::Ringing, std::to_string(n),
+			Baresip::Event::Call::Direction::Outgoing));
+	}
+	UTEST_ASSERT_EQUAL(ncalls, model->calls().size());
+	UTEST_ASSERT(model->history().empty());
+
+	for (size_t n{0}; n < ncalls; ++n) {
+		model->on_event(call_event(Baresip::Event::Call::Type::Closed, std::to_string(n),
+			Baresip::Event::Call::Direction::Outgoing));
+		UTEST_ASSERT_EQUAL(ncalls - n - 1, model->calls().size());
+	}
+
+	auto history = model->history();
+	UTEST_ASSERT_EQUAL(Baresip::Model::HistorySize, history.size());
+	UTEST_ASSERT_EQUAL(Baresip::Call::Id{"4"}, history.front()->id());
+	UTEST_ASSERT_EQUAL(Baresip::Call::Id{std::to_string(ncalls - 1)}, history.back()->id());
+	UTEST_ASSERT_EQUAL(Baresip::Call::State::Closed, history.back()->state());
+
+	// a new call reusing a closed id is a new call
+	std::shared_ptr<Baresip::Call> call;
+	model->on_call.connect([&call](auto const& c) { call = c; });
+	model->on_event(call_event(Baresip::Event::Call::Type::Incoming, "0"));
+	UTEST_ASSERT(call);
+	UTEST_ASSERT_EQUAL(size_t(1), model->calls().size());
+}
+
+UTEST_CASE_WITH_FIXTURE(call_list_snapshot_test, Fixture)
+{
+	auto empty = model->calls();
+	model->on_event(call_event(Baresip::Event::Call::Type::Incoming, "1"));
+	model->on_event(call_event(Baresip::Event::Call::Type::Incoming, "2"));
+
+	auto calls = model->calls();
+	UTEST_ASSERT(empty.empty());
+	UTEST_ASSERT_EQUAL(size_t(2), calls.size());
+
+	// unchanged models hand out the same list
+	UTEST_ASSERT(model->calls().begin() == calls.begin());
+
+	model->on_event(call_event(Baresip::Event::Call::Type::Closed, "1"));
+	UTEST_ASSERT_EQUAL(size_t(1), model->calls().size());
+	UTEST_ASSERT_EQUAL(size_t(1), model->history().size());
+
+	// earlier snapshots are not affected
+	UTEST_ASSERT_EQUAL(size_t(2), calls.size());
+	UTEST_ASSERT_EQUAL(Baresip::Call::Id{"1"}, calls[0]->id());
+	UTEST_ASSERT_EQUAL(Baresip::Call::Id{"2"}, calls[1]->id());
+}
+
 UTEST_CASE_WITH_FIXTURE(registration_ok_test, Fixture)
 {
 	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Unknown, model->registration());
@@ -213,6 +283,68 @@ UTEST_CASE_WITH_FIXTURE(registration_unregistering_test, Fixture)
 	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Unknown, model->registration());
 }
 
+UTEST_CASE_WITH_FIXTURE(registration_accounts_test, Fixture)
+{
+	std::vector<Baresip::Model::Account> changes;
+	model->on_registration.connect([&changes](auto const& account) {
+		changes.push_back(account);
+	});
+
+	model->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:1@example.com"));
+	model->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:2@example.com"));
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Ok, model->registration());
+	UTEST_ASSERT_EQUAL(size_t(2), changes.size());
+
+	// repeated events are no transitions
+	model->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:1@example.com"));
+	UTEST_ASSERT_EQUAL(size_t(2), changes.size());
+
+	model->on_event(register_event(Baresip::Event::Register::Type::Fail, "sip:2@example.com"));
+	UTEST_ASSERT_EQUAL(size_t(3), changes.size());
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Fail, model->registration());
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Ok,
+		model->registration(InternedString{"sip:1@example.com"}));
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Fail,
+		model->registration(InternedString{"sip:2@example.com"}));
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Unknown,
+		model->registration(InternedString{"sip:3@example.com"}));
+
+	model->on_event(register_event(Baresip::Event::Register::Type::Ok, "sip:2@example.com"));
+	model->on_event(register_event(Baresip::Event::Register::Type::Unregistering, "sip:1@example.com"));
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Unknown, model->registration());
+
+	auto accounts = model->accounts();
+	UTEST_ASSERT_EQUAL(size_t(2), accounts.size());
+	UTEST_ASSERT_EQUAL(std::string{"sip:1@example.com"}, std::string{accounts[0].aor.view()});
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Unknown, accounts[0].registration);
+	UTEST_ASSERT_EQUAL(uint64_t(0), accounts[0].flaps);
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Ok, accounts[1].registration);
+	UTEST_ASSERT_EQUAL(uint64_t(1), accounts[1].flaps);
+	UTEST_ASSERT(accounts[1].since >= changes[2].since);
+}
+
+UTEST_CASE_WITH_FIXTURE(registration_new_account_unknown_test, Fixture)
+{
+	auto changes = size_t{0};
+	model->on_registration.connect([&changes](auto const&) { ++changes; });
+
+	// no transition from Unknown to Unknown for a new account
+	model->on_event(Baresip::Event::Any{Baresip::Event::Register{
+		Baresip::Event::Register::Type::Unregistering,
+		"sip:9999-1@asterisk.example.com",
+		""}});
+	UTEST_ASSERT_EQUAL(size_t(0), changes);
+	UTEST_ASSERT_EQUAL(size_t(1), model->accounts().size());
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Unknown, model->registration());
+
+	model->on_event(Baresip::Event::Any{Baresip::Event::Register{
+		Baresip::Event::Register::Type::Ok,
+		"sip:9999-1@asterisk.example.com",
+		"200 OK"}});
+	UTEST_ASSERT_EQUAL(size_t(1), changes);
+	UTEST_ASSERT_EQUAL(Baresip::Model::Registration::Ok, model->registration());
+}
+
 UTEST_CASE(call_id_test)
 {
 	UTEST_ASSERT(!Baresip::Call::Id{});
@@ -0,0 +1,105 @@
+#include "utest/macros.h"
+
+#include "baresip-stub.h"
+#include "baresip/command.h"
+#include "baresip/ctrl.h"
+#include "buffered-stream-socket.h"
+#include "posix/socket.h"
+#include "posix/socket-address.h"
+#include "posix/timer-fd.h"
+#include "posix/unix-address.h"
+
+#include <unistd.h>
+
+namespace unittests {
+namespace baresip_stub {
+
+class Fixture {
+public:
+	Fixture()
+	:
+		poller{EPoll::CtrlFactory::create()->make_ctrl()},
+		socket_factory{Posix::SocketFactory::create()},
+		timerfd_factory{Posix::TimerFdFactory::create()},
+		addr{Posix::Unix::Address{"@clingeling-test-" + std::to_string(::getpid())}},
+		stub{*poller, *socket_factory, addr},
+		sock{*poller, *socket_factory, *timerfd_factory, addr},
+		ctrl{Baresip::Ctrl::create(sock.recvbuf(), sock.sendbuf())}
+	{
+		sock.on_connect.connect([this] () { ++connects; });
+		sock.on_disconnect.connect([this] (auto const&) { ctrl->reset(); });
+		stub.on_command.connect([this] (auto const& cmd) { commands.push_back(cmd); });
+		ctrl->on_event.connect([this] (auto const& ev) { events.push_back(ev); });
+		ctrl->on_response.connect([this] (auto const& resp) { responses.push_back(resp); });
+	}
+
+	template <typename Pred>
+	bool run_until(Pred const& pred)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!pred() && std::chrono::steady_clock::now() < deadline) {
+			poller->wait(std::chrono::milliseconds(100));
+		}
+		return pred();
+	}
+
+	std::unique_ptr<EPoll::Ctrl> poller;
+	std::unique_ptr<Posix::SocketFactory> socket_factory;
+	std::unique_ptr<Posix::TimerFdFactory> timerfd_factory;
+	Posix::SocketAddress addr;
+	BaresipStub stub;
+	BufferedStreamSocket sock;
+	std::unique_ptr<Baresip::Ctrl> ctrl;
+	size_t connects = 0;
+	std::vector<Json::Object> commands;
+	std::vector<Baresip::Event::Any> events;
+	std::vector<Baresip::Command::Response> responses;
+};
+
+UTEST_CASE_WITH_FIXTURE(event_test, Fixture)
+{
+	UTEST_ASSERT(run_until([this] () { return stub.clients() == 1; }));
+	UTEST_ASSERT_EQUAL(size_t(1), connects);
+
+	stub.send(Json::make_object({
+		{"event", true},
+		{"class", "register"},
+		{"type", "REGISTER_OK"},
+		{"accountaor", "sip:9999-1@asterisk.example.com"},
+		{"param", "200 OK"},
+	}));
+	UTEST_ASSERT(run_until([this] () { return !events.empty(); }));
+	UTEST_ASSERT(std::holds_alternative<Baresip::Event::Register>(events[0]));
+}
+
+UTEST_CASE_WITH_FIXTURE(command_test, Fixture)
+{
+	auto done = size_t{0};
+	for (auto i = 0; i < 10; ++i) {
+		auto token = ctrl->send({"dial", "sip:9999-2@asterisk.example.com", ""}, [&done] (auto const& resp) {
+			UTEST_ASSERT(resp.ok);
+			++done;
+		});
+		UTEST_ASSERT_EQUAL("cl-" + std::to_string(i + 1), token);
+	}
+	UTEST_ASSERT_EQUAL(size_t(10), ctrl->pending());
+
+	UTEST_ASSERT(run_until([&done] () { return done == 10; }));
+	UTEST_ASSERT_EQUAL(size_t(10), commands.size());
+	UTEST_ASSERT_EQUAL(size_t(10), responses.size());
+	UTEST_ASSERT_EQUAL(size_t(0), ctrl->pending());
+	UTEST_ASSERT_EQUAL(std::string("dial"), Json::get<std::string>(commands[0].at("command")));
+	UTEST_ASSERT_EQUAL(std::string("sip:9999-2@asterisk.example.com"), Json::get<std::string>(commands[0].at("params")));
+}
+
+UTEST_CASE_WITH_FIXTURE(reconnect_test, Fixture)
+{
+	UTEST_ASSERT(run_until([this] () { return stub.clients() == 1; }));
+	stub.disconnect();
+	UTEST_ASSERT(run_until([this] () { return connects == 2 && stub.clients() == 1; }));
+
+	ctrl->send({"hangup", "", ""});
+	UTEST_ASSERT(run_until([this] () { return !responses.empty(); }));
+}
+
+}}
@@ -4,18 +4,22 @@
 #include "posix/socket.h"
 #include "posix/inet-address.h"
 #include "posix/socket-address.h"
+#include "posix/timer-fd.h"
+
+#include <cstring>
 
 namespace EPoll {
 
 class CtrlMock : public Ctrl {
 public:
-	void add(std::shared_ptr<Posix::Fd> const& fd, Events const& ev, std::function<void(Events const&)> const& cb) override
+	void add(std::shared_ptr<Posix::Fd> const& fd, Events const& ev, InlineFunction<void(Events const&)> cb) override
 	{
-		add_.emplace_back(fd, ev, cb);
+		add_.emplace_back(fd, ev, std::move(cb));
 	}
 
-	void del(std::shared_ptr<Posix::Fd> const&) override
+	void del(std::shared_ptr<Posix::Fd> const& fd) override
 	{
+		del_.push_back(fd);
 	}
 
 	void mod(std::shared_ptr<Posix::Fd> const& fd, Events const& ev) const override
@@ -23,12 +27,33 @@ public:
 		mod_.emplace_back(fd, ev);
 	}
 
+	void defer(std::function<void()> const& fn) override
+	{
+		defer_.push_back(fn);
+	}
+
+	void post(std::function<void()> fn) override
+	{
+		defer_.push_back(std::move(fn));
+	}
+
 	bool wait(std::chrono::milliseconds const& = Infinity()) const override
 	{
 		return true;
 	}
 
-	std::vector<std::tuple<std::shared_ptr<Posix::Fd>, Events, std::function<void(Events const&)>>> add_;
+	Stats stats() const override
+	{
+		return {};
+	}
+
+	void reset_stats() override
+	{
+	}
+
+	std::vector<std::tuple<std::shared_ptr<Posix::Fd>, Events, InlineFunction<void(Events const&)>>> add_;
+	std::vector<std::shared_ptr<Posix::Fd>> del_;
+	std::vector<std::function<void()>> defer_;
 	mutable std::vector<std::tuple<std::shared_ptr<Posix::Fd>, Events>> mod_;
 };
 
@@ -45,6 +70,20 @@ public:
 	void connect(SocketAddress const& addr) const override
 	{
 		connect_.push_back(addr);
+		if (connect_error_) {
+			state_ = State::error;
+			throw std::system_error(connect_error_, std::generic_category());
+		}
+		state_ = State::in_progress;
+	}
+
+	void listen(int) const override
+	{
+	}
+
+	std::shared_ptr<Socket> accept(Fd::Options const&) const override
+	{
+		return {};
 	}
 
 	std::error_code get_socket_error() const override
@@ -56,13 +95,23 @@ public:
 	{
 	}
 
+	void set_nodelay(bool on) const override
+	{
+		nodelay_ = on;
+	}
+
 	State state() const override
 	{
-		return State::in_progress;
+		return state_;
 	}
 
 	void connect_continue() override
 	{
+		if (continue_error_) {
+			state_ = State::error;
+			throw std::system_error(continue_error_, std::generic_category());
+		}
+		state_ = State::connected;
 	}
 
 	int get() const override
@@ -70,6 +119,52 @@ public:
 		return 0;
 	}
 
+	size_t write(void const* buf, size_t size) const override
+	{
+		written_.append(static_cast<char const*>(buf), size);
+		return size;
+	}
+
+	size_t read(void *buf, size_t size) const override
+	{
+		auto res = std::min(size, readable_.size());
+		std::memcpy(buf, readable_.data(), res);
+		readable_.erase(0, res);
+		return res;
+	}
+
+	mutable std::vector<SocketAddress> connect_;
+	mutable State state_ = State::init;
+	mutable bool nodelay_ = false;
+	int connect_error_ = 0;
+	int continue_error_ = 0;
+	mutable std::string readable_;
+	mutable std::string written_;
+};
+
+class TimerFdMock : public TimerFd {
+public:
+	void set(std::chrono::nanoseconds const& value, std::chrono::nanoseconds const&) const override
+	{
+		set_.push_back(value);
+		armed_ = true;
+	}
+
+	void cancel() const override
+	{
+		armed_ = false;
+	}
+
+	uint64_t expirations() const override
+	{
+		return std::exchange(armed_, false) ? 1 : 0;
+	}
+
+	int get() const override
+	{
+		return 1;
+	}
+
 	size_t write(void const*, size_t) const override
 	{
 		return 0;
@@ -80,7 +175,19 @@ public:
 		return 0;
 	}
 
-	mutable std::vector<SocketAddress> connect_;
+	mutable std::vector<std::chrono::nanoseconds> set_;
+	mutable bool armed_ = false;
+};
+
+class TimerFdFactoryMock : public TimerFdFactory {
+public:
+	std::shared_ptr<TimerFd> make_timerfd(Fd::Options const&) const override
+	{
+		timer_ = std::make_shared<TimerFdMock>();
+		return timer_;
+	}
+
+	mutable std::shared_ptr<TimerFdMock> timer_;
 };
 
 class SocketFactoryMock : public SocketFactory {
@@ -98,10 +205,18 @@ public:
 	std::shared_ptr<StreamSocket> make_stream_socket(Params const& params) const override
 	{
 		auto res{std::make_shared<StreamSocketMock>()};
+		res->connect_error_ = connect_error_;
 		make_stream_socket_.emplace_back(params ,res);
 		return res;
 	}
 
+	std::shared_ptr<StreamSocketMock> last_socket() const
+	{
+		return std::get<1>(make_stream_socket_.back()).lock();
+	}
+
+	int connect_error_ = 0;
+
 	mutable std::vector<std::tuple<Params, std::weak_ptr<StreamSocketMock>>> make_stream_socket_;
 };
 
@@ -113,20 +228,202 @@ namespace buffered_stream_socket {
 class Fixture {
 public:
 	Fixture()
+	:
+		Fixture(BufferedStreamSocket::Params{})
+	{ }
+
+	explicit Fixture(BufferedStreamSocket::Params const& params)
 	:
 		epoll(),
 		socket_factory(),
-		sock(epoll, socket_factory, Posix::SocketAddress{Posix::Inet::Address{"127.0.0.1"}, 4444})
-	{ }
+		timerfd_factory(),
+		sock(epoll, socket_factory, timerfd_factory,
+			Posix::SocketAddress{Posix::Inet::Address{"127.0.0.1"}, 4444}, params)
+	{
+		sock.on_connect.connect([this] () { ++connects; });
+		sock.on_disconnect.connect([this] (auto const& reason) { disconnects.push_back(reason); });
+	}
+
+	// invoke the poll callback most recently registered for fd
+	void poll(std::shared_ptr<Posix::Fd> const& fd, EPoll::Events const& ev)
+	{
+		for (auto it = epoll.add_.rbegin(); it != epoll.add_.rend(); ++it) {
+			if (std::get<0>(*it) == fd) {
+				std::get<2>(*it)(ev);
+				return;
+			}
+		}
+		throw std::runtime_error("fd not polled");
+	}
+
+	void establish()
+	{
+		poll(socket_factory.last_socket(), EPoll::Events{EPoll::Event::Out});
+	}
+
+	void expire_timer()
+	{
+		poll(timerfd_factory.timer_, EPoll::Events{EPoll::Event::In});
+	}
+
+	void send(std::string const& data)
+	{
+		auto & buf = sock.sendbuf();
+		buf.reserve(data.size());
+		data.copy(static_cast<char *>(buf.wstart()), data.size());
+		buf.fill(data.size());
+	}
 
 	EPoll::CtrlMock epoll;
 	Posix::SocketFactoryMock socket_factory;
+	Posix::TimerFdFactoryMock timerfd_factory;
 	BufferedStreamSocket sock;
+	size_t connects = 0;
+	std::vector<std::string> disconnects;
+};
+
+class ReplayFixture : public Fixture {
+public:
+	ReplayFixture()
+	:
+		Fixture(BufferedStreamSocket::Params{
+			std::chrono::milliseconds(10), std::chrono::milliseconds(1000), 0.0, true})
+	{ }
 };
 
-UTEST_CASE_WITH_FIXTURE(simple_test, Fixture)
+UTEST_CASE_WITH_FIXTURE(connect_test, Fixture)
+{
+	UTEST_ASSERT_EQUAL(size_t(1), socket_factory.make_stream_socket_.size());
+	UTEST_ASSERT(BufferedStreamSocket::State::connecting == sock.state());
+	UTEST_ASSERT(EPoll::Events{EPoll::Event::Out} == std::get<1>(epoll.add_.back()));
+
+	establish();
+	UTEST_ASSERT(BufferedStreamSocket::State::connected == sock.state());
+	UTEST_ASSERT_EQUAL(size_t(1), connects);
+	UTEST_ASSERT(disconnects.empty());
+}
+
+UTEST_CASE_WITH_FIXTURE(reconnect_on_eof_test, Fixture)
+{
+	establish();
+	auto socket = socket_factory.last_socket();
+	socket->readable_ = "partial";
+	poll(socket, EPoll::Events{EPoll::Event::In});
+	UTEST_ASSERT_EQUAL(std::string("partial"), std::string(
+		static_cast<char *>(sock.recvbuf().rstart()), sock.recvbuf().rsize()));
+
+	poll(socket, EPoll::Events{EPoll::Event::In});
+	UTEST_ASSERT(BufferedStreamSocket::State::disconnected == sock.state());
+	UTEST_ASSERT_EQUAL(size_t(1), disconnects.size());
+	UTEST_ASSERT_EQUAL(socket, std::dynamic_pointer_cast<Posix::StreamSocketMock>(epoll.del_.back()));
+	UTEST_ASSERT(sock.recvbuf().empty());
+	UTEST_ASSERT_EQUAL(size_t(1), timerfd_factory.timer_->set_.size());
+
+	expire_timer();
+	UTEST_ASSERT_EQUAL(size_t(2), socket_factory.make_stream_socket_.size());
+	UTEST_ASSERT(BufferedStreamSocket::State::connecting == sock.state());
+	establish();
+	UTEST_ASSERT_EQUAL(size_t(2), connects);
+}
+
+UTEST_CASE_WITH_FIXTURE(reconnect_on_hup_test, Fixture)
+{
+	establish();
+	poll(socket_factory.last_socket(), EPoll::Events{EPoll::Event::Hup});
+	UTEST_ASSERT(BufferedStreamSocket::State::disconnected == sock.state());
+	UTEST_ASSERT_EQUAL(std::string("HUP"), disconnects.back());
+}
+
+UTEST_CASE_WITH_FIXTURE(connect_refused_test, Fixture)
 {
+	socket_factory.last_socket()->continue_error_ = ECONNREFUSED;
+	establish();
+	UTEST_ASSERT(BufferedStreamSocket::State::disconnected == sock.state());
+	UTEST_ASSERT_EQUAL(size_t(0), connects);
+	UTEST_ASSERT_EQUAL(size_t(1), disconnects.size());
 
+	socket_factory.connect_error_ = ECONNREFUSED;
+	expire_timer();
+	UTEST_ASSERT(BufferedStreamSocket::State::disconnected == sock.state());
+	UTEST_ASSERT_EQUAL(size_t(2), disconnects.size());
+	UTEST_ASSERT_EQUAL(size_t(2), timerfd_factory.timer_->set_.size());
+
+	socket_factory.connect_error_ = 0;
+	expire_timer();
+	establish();
+	UTEST_ASSERT(BufferedStreamSocket::State::connected == sock.state());
+	UTEST_ASSERT_EQUAL(size_t(1), connects);
+}
+
+UTEST_CASE_WITH_FIXTURE(discard_sendbuf_test, Fixture)
+{
+	establish();
+	send("hello");
+	poll(socket_factory.last_socket(), EPoll::Events{EPoll::Event::Hup});
+	UTEST_ASSERT(static_cast<IO::EventBuffer &>(sock.sendbuf()).empty());
+}
+
+UTEST_CASE_WITH_FIXTURE(replay_sendbuf_test, ReplayFixture)
+{
+	establish();
+	send("hello");
+	poll(socket_factory.last_socket(), EPoll::Events{EPoll::Event::Hup});
+
+	expire_timer();
+	establish();
+	auto socket = socket_factory.last_socket();
+	poll(socket, EPoll::Events{EPoll::Event::Out});
+	UTEST_ASSERT_EQUAL(std::string("hello"), socket->written_);
+}
+
+UTEST_CASE_WITH_FIXTURE(coalesce_test, Fixture)
+{
+	establish();
+	auto socket = socket_factory.last_socket();
+	UTEST_ASSERT(socket->nodelay_);
+	auto mods = epoll.mod_.size();
+
+	send("hello");
+	send(", ");
+	send("world");
+	UTEST_ASSERT_EQUAL(size_t(1), epoll.defer_.size());
+	UTEST_ASSERT(socket->written_.empty());
+
+	epoll.defer_[0]();
+	UTEST_ASSERT_EQUAL(std::string("hello, world"), socket->written_);
+	UTEST_ASSERT(sock.sendbuf().wsize() > 0);
+	UTEST_ASSERT_EQUAL(mods, epoll.mod_.size());
+
+	send("again");
+	UTEST_ASSERT_EQUAL(size_t(2), epoll.defer_.size());
+}
+
+UTEST_CASE_WITH_FIXTURE(reclaim_recvbuf_test, Fixture)
+{
+	establish();
+	auto socket = socket_factory.last_socket();
+	auto & recvbuf = sock.recvbuf();
+
+	socket->readable_ = std::string(8192, 'x');
+	poll(socket, EPoll::Events{EPoll::Event::In});
+	UTEST_ASSERT(!(std::get<1>(epoll.mod_.back()) & EPoll::Event::In));
+
+	// draining part of a full buffer makes room for reading again
+	recvbuf.drain(100);
+	UTEST_ASSERT(std::get<1>(epoll.mod_.back()) & EPoll::Event::In);
+	poll(socket, EPoll::Events{EPoll::Event::In});
+	UTEST_ASSERT_EQUAL(size_t(8192 - 4096 - 100), socket->readable_.size());
+	UTEST_ASSERT_EQUAL(size_t(4096), recvbuf.rsize());
+}
+
+UTEST_CASE(backoff_jitter_test)
+{
+	Backoff backoff{std::chrono::milliseconds(100), std::chrono::milliseconds(400), 0.5};
+	for (auto max : {100, 200, 400, 400}) {
+		auto next = backoff.next().count();
+		UTEST_ASSERT(next >= max / 2);
+		UTEST_ASSERT(next <= max);
+	}
 }
 
 }}
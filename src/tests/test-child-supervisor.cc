@@ -0,0 +1,175 @@
+#include "utest/macros.h"
+
+#include "child-supervisor.h"
+#include "posix/pid.h"
+#include "posix/signal.h"
+#include "posix/timer-fd.h"
+
+#include <sys/stat.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+namespace unittests {
+namespace child_supervisor {
+
+class Fixture {
+public:
+	Fixture()
+	:
+		poller{EPoll::CtrlFactory::create()->make_ctrl()},
+		timerfd_factory{Posix::TimerFdFactory::create()},
+		supervisor{*poller, *timerfd_factory, {{"/bin/sh", "-c", "exit 3"},
+			std::chrono::milliseconds(1), std::chrono::milliseconds(4), std::chrono::milliseconds(10000)}}
+	{
+		supervisor.on_start.connect([this](auto const& pid) { pids.push_back(pid->get()); });
+		supervisor.on_exit.connect([this](auto const& status) { exits.push_back(status); });
+	}
+
+	void run_until(size_t nexits)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (exits.size() < nexits && std::chrono::steady_clock::now() < deadline) {
+			poller->wait(std::chrono::milliseconds(100));
+		}
+	}
+
+	std::unique_ptr<EPoll::Ctrl> poller;
+	std::unique_ptr<Posix::TimerFdFactory> timerfd_factory;
+	ChildSupervisor supervisor;
+	std::vector<int> pids;
+	std::vector<Posix::Wait::Status> exits;
+};
+
+UTEST_CASE_WITH_FIXTURE(restart_test, Fixture)
+{
+	supervisor.start();
+	UTEST_ASSERT_EQUAL(size_t(1), pids.size());
+	UTEST_ASSERT(supervisor.pid());
+
+	run_until(3);
+	UTEST_ASSERT_EQUAL(size_t(3), exits.size());
+	UTEST_ASSERT(pids.size() >= 3);
+	for (auto const& status : exits) {
+		UTEST_ASSERT(status.exited());
+		UTEST_ASSERT_EQUAL(3, status.exit_status());
+	}
+	UTEST_ASSERT(pids[0] != pids[1]);
+}
+
+UTEST_CASE(failed_restart_test)
+{
+	char path[] = "/tmp/clingeling-child-XXXXXX";
+	auto fd = ::mkstemp(path);
+	UTEST_ASSERT(fd != -1);
+	::close(fd);
+	auto write_script = [&path] () {
+		std::ofstream{path} << "#!/bin/sh\nexit 3\n";
+		::chmod(path, 0700);
+	};
+	write_script();
+
+	auto poller = EPoll::CtrlFactory::create()->make_ctrl();
+	auto timerfd_factory = Posix::TimerFdFactory::create();
+	auto supervisor = ChildSupervisor{*poller, *timerfd_factory, {{path},
+		std::chrono::milliseconds(1), std::chrono::milliseconds(4), std::chrono::milliseconds(10000)}};
+	auto starts = size_t{0};
+	auto exits = size_t{0};
+	auto errors = std::vector<std::string>{};
+	supervisor.on_start.connect([&starts](auto const&) { ++starts; });
+	// the binary is gone once the child is done with it
+	supervisor.on_exit.connect([&exits, &path](auto const&) { ++exits; ::unlink(path); });
+	supervisor.on_error.connect([&errors](auto const& what) { errors.push_back(what); });
+
+	supervisor.start();
+
+	auto run_until = [&poller] (auto const& done) {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!done() && std::chrono::steady_clock::now() < deadline) {
+			poller->wait(std::chrono::milliseconds(100));
+		}
+	};
+
+	// restarts fail but are retried
+	run_until([&errors] () { return errors.size() >= 2; });
+	UTEST_ASSERT(errors.size() >= 2);
+	UTEST_ASSERT_EQUAL(size_t(1), starts);
+	UTEST_ASSERT(!supervisor.pid());
+
+	write_script();
+	run_until([&exits] () { return exits >= 2; });
+	UTEST_ASSERT_EQUAL(size_t(2), starts);
+	UTEST_ASSERT_EQUAL(size_t(2), exits);
+}
+
+UTEST_CASE(spawn_signal_mask_test)
+{
+	// blocked and ignored signals of the parent must not leak into
+	// the child, it could not be stopped with SIGTERM otherwise
+	sigset_t mask;
+	sigset_t old;
+	::sigemptyset(&mask);
+	::sigaddset(&mask, SIGTERM);
+	::sigaddset(&mask, SIGPIPE);
+	::pthread_sigmask(SIG_BLOCK, &mask, &old);
+	auto old_int = ::signal(SIGINT, SIG_IGN);
+
+	auto pid = Posix::Pid::spawn({"sleep", "10"});
+
+	::signal(SIGINT, old_int);
+	::pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+	auto sigblk = uint64_t{~0ULL};
+	auto sigign = uint64_t{~0ULL};
+	auto status = std::ifstream{"/proc/" + std::to_string(pid->get()) + "/status"};
+	for (auto line = std::string{}; std::getline(status, line);) {
+		if (line.rfind("SigBlk:", 0) == 0) {
+			sigblk = std::stoull(line.substr(7), nullptr, 16);
+		} else if (line.rfind("SigIgn:", 0) == 0) {
+			sigign = std::stoull(line.substr(7), nullptr, 16);
+		}
+	}
+
+	pid->kill(Posix::Signal::Term);
+	auto res = pid->wait(Posix::Wait::Option::None);
+
+	UTEST_ASSERT_EQUAL(uint64_t(0), sigblk);
+	UTEST_ASSERT_EQUAL(uint64_t(0), sigign & (uint64_t(1) << (SIGINT - 1)));
+	UTEST_ASSERT(res.signaled());
+	UTEST_ASSERT_EQUAL(SIGTERM, res.termsig());
+}
+
+UTEST_CASE(backoff_test)
+{
+	Backoff backoff{std::chrono::milliseconds(10), std::chrono::milliseconds(50)};
+	UTEST_ASSERT_EQUAL(10, backoff.next().count());
+	UTEST_ASSERT_EQUAL(20, backoff.next().count());
+	UTEST_ASSERT_EQUAL(40, backoff.next().count());
+	UTEST_ASSERT_EQUAL(50, backoff.next().count());
+	UTEST_ASSERT_EQUAL(50, backoff.next().count());
+	backoff.reset();
+	UTEST_ASSERT_EQUAL(10, backoff.next().count());
+}
+
+UTEST_CASE(timerfd_test)
+{
+	auto timer = Posix::TimerFdFactory::create()->make_timerfd(Posix::Fd::Options{Posix::Fd::Option::nonblock});
+	UTEST_ASSERT_EQUAL(uint64_t(0), timer->expirations());
+
+	timer->set(std::chrono::nanoseconds(0));
+	auto poller = EPoll::CtrlFactory::create()->make_ctrl();
+	auto expired = uint64_t{0};
+	poller->add(timer, EPoll::Events{EPoll::Event::In}, [&timer, &expired](auto const&) {
+		expired += timer->expirations();
+	});
+	UTEST_ASSERT(poller->wait(std::chrono::milliseconds(1000)));
+	UTEST_ASSERT_EQUAL(uint64_t(1), expired);
+
+	timer->set(std::chrono::seconds(10));
+	timer->cancel();
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+}
+
+}}
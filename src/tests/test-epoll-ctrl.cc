@@ -0,0 +1,172 @@
+#include "utest/macros.h"
+
+#include "epoll/ctrl.h"
+#include "posix/fd.h"
+#include "posix/pipe-factory.h"
+
+#include <thread>
+
+namespace unittests {
+namespace epoll_ctrl {
+
+class Fixture {
+public:
+	explicit Fixture(bool instrument)
+	:
+		poller{EPoll::CtrlFactory::create()->make_ctrl({instrument})},
+		pipe{Posix::PipeFactory::create()->make_pipe({true, true})}
+	{
+		poller->add(std::get<0>(pipe), EPoll::Events{EPoll::Event::In}, [this](auto const&) {
+			char c;
+			std::get<0>(pipe)->read(&c, sizeof(c));
+			++called;
+		});
+	}
+
+	void trigger()
+	{
+		char c{0};
+		std::get<1>(pipe)->write(&c, sizeof(c));
+	}
+
+	std::unique_ptr<EPoll::Ctrl> poller;
+	Posix::Pipe pipe;
+	size_t called = 0;
+};
+
+class PlainFixture : public Fixture {
+public:
+	PlainFixture() : Fixture(false) {}
+};
+
+class InstrumentedFixture : public Fixture {
+public:
+	InstrumentedFixture() : Fixture(true) {}
+};
+
+UTEST_CASE_WITH_FIXTURE(timeout_test, PlainFixture)
+{
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT_EQUAL(size_t(0), called);
+}
+
+UTEST_CASE_WITH_FIXTURE(dispatch_test, PlainFixture)
+{
+	trigger();
+	UTEST_ASSERT(poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT_EQUAL(size_t(1), called);
+
+	auto stats = poller->stats();
+	UTEST_ASSERT_EQUAL(uint64_t(0), stats.wait.count());
+	UTEST_ASSERT(stats.handlers.empty());
+}
+
+UTEST_CASE_WITH_FIXTURE(instrumented_test, InstrumentedFixture)
+{
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+	trigger();
+	UTEST_ASSERT(poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT_EQUAL(size_t(1), called);
+
+	auto stats = poller->stats();
+	UTEST_ASSERT_EQUAL(uint64_t(2), stats.wait.count());
+	UTEST_ASSERT_EQUAL(uint64_t(2), stats.events.count());
+	UTEST_ASSERT_EQUAL(uint64_t(1), stats.events.max());
+	UTEST_ASSERT_EQUAL(uint64_t(2), stats.dispatch.count());
+	UTEST_ASSERT_EQUAL(size_t(1), stats.handlers.size());
+
+	auto handler = stats.handlers.find(std::get<0>(pipe)->get());
+	UTEST_ASSERT(handler != stats.handlers.end());
+	UTEST_ASSERT_EQUAL(uint64_t(1), handler->second.count());
+	UTEST_ASSERT(!to_string(stats).empty());
+
+	poller->reset_stats();
+	UTEST_ASSERT_EQUAL(uint64_t(0), poller->stats().wait.count());
+}
+
+UTEST_CASE(delete_while_dispatching_test)
+{
+	auto poller = EPoll::CtrlFactory::create()->make_ctrl();
+	auto pipe_factory = Posix::PipeFactory::create();
+	auto pipes = std::vector<Posix::Pipe>{pipe_factory->make_pipe({true, true}), pipe_factory->make_pipe({true, true})};
+
+	// whichever callback runs first deletes both
+	size_t called{0};
+	for (auto const& pipe : pipes) {
+		poller->add(std::get<0>(pipe), EPoll::Events{EPoll::Event::In}, [&](auto const&) {
+			++called;
+			for (auto const& p : pipes) {
+				poller->del(std::get<0>(p));
+			}
+		});
+		char c{0};
+		std::get<1>(pipe)->write(&c, sizeof(c));
+	}
+
+	UTEST_ASSERT(poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT_EQUAL(size_t(1), called);
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+}
+
+UTEST_CASE_WITH_FIXTURE(defer_test, PlainFixture)
+{
+	auto order = std::vector<std::string>{};
+	poller->defer([&] () {
+		order.push_back("deferred");
+		poller->defer([&] () { order.push_back("nested"); });
+	});
+	UTEST_ASSERT(order.empty());
+
+	// pending work makes wait() return right away
+	trigger();
+	UTEST_ASSERT(poller->wait());
+	UTEST_ASSERT_EQUAL(size_t(1), called);
+	UTEST_ASSERT_EQUAL(size_t(2), order.size());
+	UTEST_ASSERT_EQUAL(std::string("deferred"), order[0]);
+	UTEST_ASSERT_EQUAL(std::string("nested"), order[1]);
+
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+}
+
+UTEST_CASE_WITH_FIXTURE(post_test, PlainFixture)
+{
+	auto order = std::vector<size_t>{};
+	auto loop_thread = std::this_thread::get_id();
+	bool same_thread{true};
+
+	auto worker = std::thread{[&] () {
+		for (size_t n{0}; n < 3; ++n) {
+			poller->post([&, n] () {
+				same_thread = same_thread && std::this_thread::get_id() == loop_thread;
+				order.push_back(n);
+			});
+		}
+	}};
+	worker.join();
+
+	// a single wakeup delivers the whole batch in order
+	UTEST_ASSERT(poller->wait());
+	UTEST_ASSERT(same_thread);
+	UTEST_ASSERT_EQUAL(size_t(3), order.size());
+	UTEST_ASSERT_EQUAL(size_t(0), order[0]);
+	UTEST_ASSERT_EQUAL(size_t(2), order[2]);
+
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+}
+
+UTEST_CASE_WITH_FIXTURE(post_wakeup_test, PlainFixture)
+{
+	bool posted{false};
+	auto worker = std::thread{[&] () {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		poller->post([&] () { posted = true; });
+	}};
+
+	// blocks until the worker posts
+	UTEST_ASSERT(poller->wait());
+	worker.join();
+	UTEST_ASSERT(posted);
+	UTEST_ASSERT_EQUAL(size_t(0), called);
+}
+
+}}
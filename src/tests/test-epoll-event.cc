@@ -2,6 +2,8 @@
 
 #include "epoll/ctrl.h"
 
+#include <vector>
+
 namespace unittests {
 namespace EpollEvent {
 
@@ -65,4 +67,42 @@ UTEST_CASE(clingeling_test)
 	UTEST_ASSERT(!(ev & EPoll::Event::In));
 }
 
+UTEST_CASE(count_test)
+{
+	UTEST_ASSERT_EQUAL(size_t(0), EPoll::Events{}.count());
+	UTEST_ASSERT_EQUAL(size_t(1), EPoll::Events{EPoll::Event::Hup}.count());
+	UTEST_ASSERT_EQUAL(size_t(3), (EPoll::Event::In|EPoll::Event::Err|EPoll::Event::Hup).count());
+}
+
+UTEST_CASE(iterate_test)
+{
+	auto seen = std::vector<EPoll::Event>{};
+	for (auto ev : EPoll::Event::Hup|EPoll::Event::In|EPoll::Event::Err) {
+		seen.push_back(ev);
+	}
+
+	UTEST_ASSERT_EQUAL(size_t(3), seen.size());
+	UTEST_ASSERT(seen[0] == EPoll::Event::In);
+	UTEST_ASSERT(seen[1] == EPoll::Event::Err);
+	UTEST_ASSERT(seen[2] == EPoll::Event::Hup);
+
+	UTEST_ASSERT(EPoll::Events{}.begin() == EPoll::Events{}.end());
+}
+
+UTEST_CASE(dispatch_test)
+{
+	auto order = std::vector<int>{};
+	auto record = [&order] (int n) { return [&order, n] () { order.push_back(n); }; };
+
+	// ascending flag order, not argument order, unset flags skipped
+	dispatch(EPoll::Event::Hup|EPoll::Event::In|EPoll::Event::Pri,
+		on_flag(EPoll::Event::Hup, record(1)),
+		on_flag(EPoll::Event::Out, record(2)),
+		on_flag(EPoll::Event::In, record(3)));
+
+	UTEST_ASSERT_EQUAL(size_t(2), order.size());
+	UTEST_ASSERT_EQUAL(3, order[0]);
+	UTEST_ASSERT_EQUAL(1, order[1]);
+}
+
 }}
@@ -2,6 +2,8 @@
 
 #include "fmt.h"
 
+#include <string_view>
+
 namespace unittests {
 namespace format {
 
@@ -68,4 +70,46 @@ UTEST_CASE(simple_test)
 	}
 }
 
+UTEST_CASE(types_test)
+{
+	UTEST_ASSERT_EQUAL(std::string("a b c"), Fmt::format("%s %s %s", 'a', std::string("b"), std::string_view("c")));
+	UTEST_ASSERT_EQUAL(std::string("-12 1 0"), Fmt::format("%s %s %s", -12, true, false));
+	UTEST_ASSERT_EQUAL(std::string("0xffffffff"), Fmt::format("%x", -1));
+	UTEST_ASSERT_EQUAL(std::string("1.5"), Fmt::format("%s", 1.5));
+	UTEST_ASSERT_EQUAL(std::string("(null)"), Fmt::format("%s", static_cast<char const*>(nullptr)));
+}
+
+UTEST_CASE(escape_test)
+{
+	UTEST_ASSERT_EQUAL(std::string("100% 1"), Fmt::format("100%% %s", 1));
+	UTEST_ASSERT_EQUAL(std::string("1 %s"), Fmt::format("%s %s", 1));
+	UTEST_ASSERT_EQUAL(std::string("1"), Fmt::format("%s%", 1, 2));
+}
+
+UTEST_CASE(placeholders_test)
+{
+	static_assert(Fmt::placeholders("") == 0);
+	static_assert(Fmt::placeholders("%") == 0);
+	static_assert(Fmt::placeholders("%%") == 0);
+	static_assert(Fmt::placeholders("%s %x %%") == 2);
+	static_assert(Fmt::placeholders("::bind(%s, %s, %s);") == 3);
+
+	UTEST_ASSERT_EQUAL(std::string("1 0x2"), FMT_FORMAT("%s %x", 1, 2));
+}
+
+UTEST_CASE(format_to_test)
+{
+	char buf[8];
+	auto len = Fmt::format_to(buf, sizeof(buf), "fd %s", 42);
+	UTEST_ASSERT_EQUAL(size_t(5), len);
+	UTEST_ASSERT_EQUAL(std::string("fd 42"), std::string(buf, len));
+
+	// truncated like snprintf, but the full length is reported
+	len = Fmt::format_to(buf, sizeof(buf), "%s %s", std::string("abcdef"), 12345);
+	UTEST_ASSERT_EQUAL(size_t(12), len);
+	UTEST_ASSERT_EQUAL(std::string("abcdef 1"), std::string(buf, sizeof(buf)));
+
+	UTEST_ASSERT_EQUAL(size_t(3), Fmt::format_to(nullptr, 0, "%s", 100));
+}
+
 }}
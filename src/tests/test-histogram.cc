@@ -0,0 +1,78 @@
+#include "utest/macros.h"
+
+#include "histogram.h"
+
+namespace unittests {
+namespace histogram {
+
+UTEST_CASE(empty_test)
+{
+	Histogram h;
+	UTEST_ASSERT_EQUAL(uint64_t(0), h.count());
+	UTEST_ASSERT_EQUAL(uint64_t(0), h.min());
+	UTEST_ASSERT_EQUAL(uint64_t(0), h.max());
+	UTEST_ASSERT_EQUAL(uint64_t(0), h.percentile(50.0));
+}
+
+UTEST_CASE(exact_small_values_test)
+{
+	Histogram h;
+	for (uint64_t v{1}; v <= 10; ++v) {
+		h.record(v);
+	}
+
+	UTEST_ASSERT_EQUAL(uint64_t(10), h.count());
+	UTEST_ASSERT_EQUAL(uint64_t(1), h.min());
+	UTEST_ASSERT_EQUAL(uint64_t(10), h.max());
+	UTEST_ASSERT_EQUAL(uint64_t(5), h.percentile(50.0));
+	UTEST_ASSERT_EQUAL(uint64_t(9), h.percentile(90.0));
+	UTEST_ASSERT_EQUAL(uint64_t(10), h.percentile(100.0));
+	UTEST_ASSERT_EQUAL(5.5, h.mean());
+}
+
+UTEST_CASE(index_test)
+{
+	UTEST_ASSERT_EQUAL(size_t(0), Histogram::index(0));
+	UTEST_ASSERT_EQUAL(size_t(31), Histogram::index(31));
+	UTEST_ASSERT_EQUAL(size_t(32), Histogram::index(32));
+	UTEST_ASSERT_EQUAL(size_t(32), Histogram::index(33));
+	UTEST_ASSERT_EQUAL(size_t(33), Histogram::index(34));
+	UTEST_ASSERT_EQUAL(Histogram::Buckets - 1, Histogram::index(~uint64_t(0)));
+
+	for (uint64_t v : {uint64_t(100), uint64_t(1000), uint64_t(123456789)}) {
+		auto high = Histogram::highest_equivalent(Histogram::index(v));
+		UTEST_ASSERT(high >= v);
+		UTEST_ASSERT(high - v <= v / Histogram::SubBuckets);
+	}
+}
+
+UTEST_CASE(percentile_precision_test)
+{
+	Histogram h;
+	for (uint64_t v{1}; v <= 100000; ++v) {
+		h.record(v);
+	}
+
+	auto p99 = h.percentile(99.0);
+	UTEST_ASSERT(p99 >= 99000);
+	UTEST_ASSERT(p99 <= 99000 + 99000 / Histogram::SubBuckets);
+	UTEST_ASSERT_EQUAL(uint64_t(100000), h.percentile(100.0));
+}
+
+UTEST_CASE(merge_test)
+{
+	Histogram h1;
+	h1.record(5);
+	Histogram h2;
+	h2.record(1000);
+
+	h1 += h2;
+	UTEST_ASSERT_EQUAL(uint64_t(2), h1.count());
+	UTEST_ASSERT_EQUAL(uint64_t(5), h1.min());
+	UTEST_ASSERT_EQUAL(uint64_t(1000), h1.max());
+
+	h1.reset();
+	UTEST_ASSERT_EQUAL(uint64_t(0), h1.count());
+}
+
+}}
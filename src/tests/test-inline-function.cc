@@ -0,0 +1,125 @@
+#include "utest/macros.h"
+
+#include "inline-function.h"
+
+#include <memory>
+#include <string>
+
+namespace unittests {
+namespace inline_function {
+
+namespace {
+
+int twice(int n)
+{
+	return 2 * n;
+}
+
+struct Counted {
+	explicit Counted(int *alive_)
+	:
+		alive(alive_)
+	{
+		++*alive;
+	}
+
+	Counted(Counted && o) noexcept
+	:
+		alive(o.alive)
+	{
+		++*alive;
+	}
+
+	~Counted()
+	{
+		--*alive;
+	}
+
+	void operator()() const
+	{ }
+
+	int *alive;
+};
+
+}
+
+UTEST_CASE(empty_test)
+{
+	InlineFunction<void()> fn;
+	UTEST_ASSERT(!fn);
+	UTEST_ASSERT_THROW(fn(), std::bad_function_call);
+}
+
+UTEST_CASE(null_test)
+{
+	UTEST_ASSERT(!InlineFunction<void()>{nullptr});
+	UTEST_ASSERT(!InlineFunction<int(int)>{static_cast<int (*)(int)>(nullptr)});
+	UTEST_ASSERT(!InlineFunction<void()>{std::function<void()>{}});
+}
+
+UTEST_CASE(invoke_test)
+{
+	int offset{3};
+	InlineFunction<int(int)> lambda{[&offset](int n) { return n + offset; }};
+	InlineFunction<int(int)> fptr{twice};
+	InlineFunction<int(int)> func{std::function<int(int)>{twice}};
+
+	UTEST_ASSERT_EQUAL(5, lambda(2));
+	UTEST_ASSERT_EQUAL(4, fptr(2));
+	UTEST_ASSERT_EQUAL(4, func(2));
+}
+
+UTEST_CASE(arguments_test)
+{
+	std::string seen;
+	InlineFunction<void(std::string const&, std::unique_ptr<int>)> fn{
+		[&seen](std::string const& s, std::unique_ptr<int> p) {
+			seen = s + std::to_string(*p);
+		}};
+
+	fn("a", std::make_unique<int>(1));
+	UTEST_ASSERT_EQUAL(std::string("a1"), seen);
+}
+
+UTEST_CASE(mutable_test)
+{
+	InlineFunction<int()> fn{[n = 0] () mutable { return ++n; }};
+	UTEST_ASSERT_EQUAL(1, fn());
+	UTEST_ASSERT_EQUAL(2, fn());
+}
+
+UTEST_CASE(move_test)
+{
+	InlineFunction<int()> a{[n = 41] () { return n + 1; }};
+	InlineFunction<int()> b{std::move(a)};
+	UTEST_ASSERT(!a);
+	UTEST_ASSERT_EQUAL(42, b());
+
+	a = std::move(b);
+	UTEST_ASSERT(!b);
+	UTEST_ASSERT_EQUAL(42, a());
+
+	a = nullptr;
+	UTEST_ASSERT(!a);
+}
+
+UTEST_CASE(lifetime_test)
+{
+	int alive{0};
+	{
+		InlineFunction<void()> a{Counted{&alive}};
+		UTEST_ASSERT_EQUAL(1, alive);
+
+		InlineFunction<void()> b{std::move(a)};
+		UTEST_ASSERT_EQUAL(1, alive);
+
+		b = [] () { };
+		UTEST_ASSERT_EQUAL(0, alive);
+
+		a = Counted{&alive};
+		UTEST_ASSERT_EQUAL(1, alive);
+	}
+	UTEST_ASSERT_EQUAL(0, alive);
+}
+
+}}
@@ -0,0 +1,50 @@
+#include "utest/macros.h"
+#include "interned-string.h"
+
+#include <unordered_set>
+
+namespace unittests {
+namespace interned_string {
+
+UTEST_CASE(simple_test)
+{
+	auto a = InternedString{"sip:9999-1@asterisk.example.com"};
+	auto b = InternedString{std::string{"sip:9999-1@asterisk.example.com"}};
+	auto c = InternedString{"sip:9999-2@asterisk.example.com"};
+
+	UTEST_ASSERT(a == b);
+	UTEST_ASSERT(a != c);
+	UTEST_ASSERT_EQUAL(a.view().data(), b.view().data());
+	UTEST_ASSERT_EQUAL(std::string_view{"sip:9999-1@asterisk.example.com"}, a.view());
+	UTEST_ASSERT_EQUAL(std::string{"sip:9999-2@asterisk.example.com"}, to_string(c));
+}
+
+UTEST_CASE(empty_test)
+{
+	UTEST_ASSERT(InternedString{}.empty());
+	UTEST_ASSERT(InternedString{} == InternedString{""});
+	UTEST_ASSERT(InternedString{} != InternedString{"a"});
+}
+
+UTEST_CASE(order_test)
+{
+	// intern in reverse to make sure the order is not by address
+	auto b = InternedString{"order-test-b"};
+	auto a = InternedString{"order-test-a"};
+	UTEST_ASSERT(a < b);
+	UTEST_ASSERT(b > a);
+	UTEST_ASSERT(!(a < a));
+}
+
+UTEST_CASE(pool_test)
+{
+	auto size = InternedString::pool_size();
+	auto set = std::unordered_set<InternedString>{};
+	for (auto i = 0; i < 100; ++i) {
+		set.insert(InternedString{"pool-test"});
+	}
+	UTEST_ASSERT_EQUAL(size_t(1), set.size());
+	UTEST_ASSERT_EQUAL(size + 1, InternedString::pool_size());
+}
+
+}}
@@ -59,6 +59,15 @@ UTEST_CASE(simple_object_test)
 	UTEST_ASSERT_EQUAL(std::string{"bar"}, Json::get<std::string>(o["foo"]));
 }
 
+UTEST_CASE(whitespace_object_test)
+{
+	std::stringstream is{"{ \"foo\" : \"bar\" , \"baz\": true }"};
+	auto o = Json::parse_object(is);
+	UTEST_ASSERT_EQUAL(size_t(2), o.size());
+	UTEST_ASSERT_EQUAL(std::string{"bar"}, Json::get<std::string>(o["foo"]));
+	UTEST_ASSERT_EQUAL(true, Json::get<bool>(o["baz"]));
+}
+
 UTEST_CASE(empty_array_test)
 {
 	{
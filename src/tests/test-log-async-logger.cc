@@ -0,0 +1,151 @@
+#include "utest/macros.h"
+
+#include "log/async-logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unittests {
+namespace log_async_logger {
+
+class Fixture {
+public:
+	Fixture()
+	{
+		logger.on_message([this] (Log::Message const& msg) {
+			while (blocked) {
+				std::this_thread::yield();
+			}
+			auto lock = std::lock_guard<std::mutex>{mutex};
+			messages.push_back(msg.get_msg());
+			threads.push_back(std::this_thread::get_id());
+		});
+	}
+
+	Log::Logger logger;
+	std::atomic<bool> blocked{false};
+	std::mutex mutex;
+	std::vector<std::string> messages;
+	std::vector<std::thread::id> threads;
+};
+
+UTEST_CASE_WITH_FIXTURE(post_test, Fixture)
+{
+	auto async = Log::AsyncLogger::create(logger);
+	async->post(Log::make_message("%s %s", "first", 1));
+	async->post(Log::make_message("%s %s", "second", 2));
+	async->flush();
+
+	UTEST_ASSERT_EQUAL(size_t(2), messages.size());
+	UTEST_ASSERT_EQUAL(std::string("first 1"), messages[0]);
+	UTEST_ASSERT_EQUAL(std::string("second 2"), messages[1]);
+	UTEST_ASSERT(threads[0] != std::this_thread::get_id());
+
+	auto stats = async->stats();
+	UTEST_ASSERT_EQUAL(uint64_t(2), stats.posted);
+	UTEST_ASSERT_EQUAL(uint64_t(0), stats.dropped);
+	UTEST_ASSERT_EQUAL(uint64_t(2), stats.written);
+}
+
+UTEST_CASE_WITH_FIXTURE(drop_test, Fixture)
+{
+	auto async = Log::AsyncLogger::create(logger, {2, Log::AsyncLogger::Policy::Drop});
+
+	// the sink stalls, post() must not
+	blocked = true;
+	for (size_t n{0}; n < 10; ++n) {
+		async->post(Log::Message{"msg"});
+	}
+	auto stats = async->stats();
+	UTEST_ASSERT_EQUAL(uint64_t(10), stats.posted + stats.dropped);
+	UTEST_ASSERT(stats.dropped >= 7);
+
+	blocked = false;
+	async->flush();
+	UTEST_ASSERT_EQUAL(stats.posted, async->stats().written);
+}
+
+UTEST_CASE_WITH_FIXTURE(block_test, Fixture)
+{
+	auto async = Log::AsyncLogger::create(logger, {2, Log::AsyncLogger::Policy::Block});
+
+	auto workers = std::vector<std::thread>{};
+	for (size_t w{0}; w < 4; ++w) {
+		workers.emplace_back([&async] () {
+			for (size_t n{0}; n < 100; ++n) {
+				async->post(Log::Message{"msg"});
+			}
+		});
+	}
+	for (auto & worker : workers) {
+		worker.join();
+	}
+	async->flush();
+
+	auto stats = async->stats();
+	UTEST_ASSERT_EQUAL(uint64_t(400), stats.posted);
+	UTEST_ASSERT_EQUAL(uint64_t(0), stats.dropped);
+	UTEST_ASSERT_EQUAL(size_t(400), messages.size());
+}
+
+UTEST_CASE_WITH_FIXTURE(exited_threads_test, Fixture)
+{
+	auto async = Log::AsyncLogger::create(logger);
+
+	for (size_t w{0}; w < 4; ++w) {
+		auto worker = std::thread([&async] () {
+			for (size_t n{0}; n < 10; ++n) {
+				async->post(Log::Message{"msg"});
+			}
+		});
+		worker.join();
+		async->flush();
+	}
+
+	// let the idle writer drop the rings, their counts must stay
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	auto stats = async->stats();
+	UTEST_ASSERT_EQUAL(uint64_t(40), stats.posted);
+	UTEST_ASSERT_EQUAL(uint64_t(40), stats.written);
+
+	async->post(Log::Message{"msg"});
+	async->flush();
+	UTEST_ASSERT_EQUAL(uint64_t(41), async->stats().posted);
+	UTEST_ASSERT_EQUAL(size_t(41), messages.size());
+}
+
+UTEST_CASE(sigmask_test)
+{
+	auto blocked = std::atomic<int>{-1};
+	auto logger = Log::Logger{};
+	logger.on_message([&blocked] (Log::Message const&) {
+		sigset_t mask;
+		::pthread_sigmask(SIG_BLOCK, nullptr, &mask);
+		blocked = ::sigismember(&mask, SIGINT) + ::sigismember(&mask, SIGTERM);
+	});
+
+	auto async = Log::AsyncLogger::create(logger);
+	async->post(Log::Message{"msg"});
+	async->flush();
+	UTEST_ASSERT_EQUAL(2, blocked.load());
+
+	// the mask of the creating thread is left alone
+	sigset_t mask;
+	::pthread_sigmask(SIG_BLOCK, nullptr, &mask);
+	UTEST_ASSERT(!::sigismember(&mask, SIGINT));
+}
+
+UTEST_CASE_WITH_FIXTURE(destroy_test, Fixture)
+{
+	{
+		auto async = Log::AsyncLogger::create(logger);
+		async->post(Log::Message{"last words"});
+	}
+	UTEST_ASSERT_EQUAL(size_t(1), messages.size());
+}
+
+}}
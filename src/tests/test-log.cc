@@ -0,0 +1,166 @@
+#include "utest/macros.h"
+
+#include "log.h"
+#include "log/binary.h"
+#include "posix/fd.h"
+#include "posix/pipe-factory.h"
+
+#include <vector>
+
+namespace unittests {
+namespace log {
+
+class Fixture {
+public:
+	Fixture()
+	{
+		logger.on_message([this] (Log::Message const& msg) { messages.push_back(msg); });
+	}
+
+	Log::Logger logger;
+	std::vector<Log::Message> messages;
+};
+
+UTEST_CASE(args_test)
+{
+	auto args = Log::Args(true, 'c', -3, uint64_t(42), 1.5, "str", std::string("ing"));
+	UTEST_ASSERT_EQUAL(size_t(7), args.count());
+
+	auto text = std::string{};
+	args.format(text, "%s %s %s %x %s %s%s");
+	UTEST_ASSERT_EQUAL(std::string("1 c -3 0x2a 1.5 string"), text);
+
+	// the bytes are self contained
+	text.clear();
+	Log::Args::from_bytes(args.bytes()).format(text, "%s %s %s %x %s %s%s");
+	UTEST_ASSERT_EQUAL(std::string("1 c -3 0x2a 1.5 string"), text);
+}
+
+UTEST_CASE(args_overflow_test)
+{
+	auto args = Log::Args(std::string(200, 'x'), 1);
+	UTEST_ASSERT_EQUAL(size_t(1), args.count());
+	UTEST_ASSERT_EQUAL(Log::Args::Capacity, args.bytes().size());
+
+	auto text = std::string{};
+	args.format(text, "%s %s");
+	UTEST_ASSERT_EQUAL(std::string(Log::Args::Capacity - 2, 'x') + " %s", text);
+
+	// an int takes 5 bytes, all three fit
+	auto fits = Log::Args(std::string(102, 'x'), 12345, 'c');
+	UTEST_ASSERT_EQUAL(size_t(3), fits.count());
+	text.clear();
+	fits.format(text, "s=%s n=%s c=%s");
+	UTEST_ASSERT_EQUAL("s=" + std::string(102, 'x') + " n=12345 c=c", text);
+
+	// nothing after a dropped argument is stored, even if it would fit
+	auto dropped = Log::Args(std::string(106, 'x'), 12345, 'c');
+	UTEST_ASSERT_EQUAL(size_t(1), dropped.count());
+	text.clear();
+	dropped.format(text, "s=%s n=%s c=%s");
+	UTEST_ASSERT_EQUAL("s=" + std::string(106, 'x') + " n=%s c=%s", text);
+
+	UTEST_ASSERT_THROW(Log::Args::from_bytes(std::string_view("\x05\x09xx", 4)), std::runtime_error);
+	UTEST_ASSERT_THROW(Log::Args::from_bytes(std::string_view("\x20", 1)), std::runtime_error);
+	UTEST_ASSERT_THROW(Log::Args::from_bytes(std::string_view("\x07\x01", 2)), std::runtime_error);
+}
+
+UTEST_CASE(args_width_test)
+{
+	// deferred formatting has to match direct formatting, which
+	// depends on the width of negative values for %x
+	auto args = Log::Args(-1, short(-2), int64_t(-3), uint16_t(0xfffe), uint32_t(7), -4L);
+	auto fmt = "%x %x %x %x %x %s";
+	auto text = std::string{};
+	Log::Args::from_bytes(args.bytes()).format(text, fmt);
+	UTEST_ASSERT_EQUAL(Fmt::format(fmt, -1, short(-2), int64_t(-3), uint16_t(0xfffe), uint32_t(7), -4L), text);
+	UTEST_ASSERT_EQUAL(std::string("0xffffffff 0xfffe 0xfffffffffffffffd 0xfffe 0x7 -4"), text);
+}
+
+UTEST_CASE_WITH_FIXTURE(deferred_test, Fixture)
+{
+	auto name = std::string("button");
+	LOG_INFO(logger, "%s %s pressed", name, 3);
+	LOG_ERROR(logger, "plain");
+	name = "changed";
+
+	UTEST_ASSERT_EQUAL(size_t(2), messages.size());
+	UTEST_ASSERT(messages[0].format() != nullptr);
+	UTEST_ASSERT(messages[0].level() == Log::Level::Info);
+	UTEST_ASSERT_EQUAL(std::string("button 3 pressed"), messages[0].get_msg());
+	UTEST_ASSERT(messages[1].level() == Log::Level::Error);
+	UTEST_ASSERT_EQUAL(std::string("plain"), messages[1].get_msg());
+
+	UTEST_ASSERT_EQUAL(std::string("text"), Log::Message{"text"}.get_msg());
+	UTEST_ASSERT(Log::Message{"text"}.format() == nullptr);
+}
+
+UTEST_CASE_WITH_FIXTURE(binary_test, Fixture)
+{
+	auto pipe = Posix::PipeFactory::create()->make_pipe({false, true});
+	{
+		auto writer = Log::Binary::Writer(std::get<1>(pipe));
+		for (int n{0}; n < 3; ++n) {
+			writer.write(Log::Message::deferred(Log::Level::Debug, "event %s", n));
+		}
+		writer.write(Log::Message{"formatted", Log::Level::Warning});
+	}
+
+	char buf[1024];
+	auto size = std::get<0>(pipe)->read(buf, sizeof(buf));
+	auto reader = Log::Binary::Reader(std::string_view(buf, size));
+
+	auto level = Log::Level::Info;
+	auto text = std::string{};
+	for (int n{0}; n < 3; ++n) {
+		UTEST_ASSERT(reader.next(level, text));
+		UTEST_ASSERT(level == Log::Level::Debug);
+		UTEST_ASSERT_EQUAL("event " + std::to_string(n), text);
+	}
+	UTEST_ASSERT(reader.next(level, text));
+	UTEST_ASSERT(level == Log::Level::Warning);
+	UTEST_ASSERT_EQUAL(std::string("formatted"), text);
+	UTEST_ASSERT(!reader.next(level, text));
+
+	// the format is written once, the messages only add their arguments
+	UTEST_ASSERT(size < 4 + 3 * 16 + 16);
+}
+
+UTEST_CASE(binary_buffer_test)
+{
+	auto pipe = Posix::PipeFactory::create()->make_pipe({true, true});
+	auto writer = Log::Binary::Writer(std::get<1>(pipe), {64});
+
+	char buf[1024];
+	auto pending = [&pipe, &buf] () {
+		try {
+			return std::get<0>(pipe)->read(buf, sizeof(buf));
+		} catch (std::system_error const&) {
+			return size_t(0);
+		}
+	};
+	UTEST_ASSERT_EQUAL(size_t(4), pending());
+
+	// buffered until buffer_size is reached
+	auto written = size_t{0};
+	auto count = 0;
+	while (written == 0) {
+		writer.write(Log::Message::deferred(Log::Level::Debug, "event %s", count++));
+		written = pending();
+	}
+	UTEST_ASSERT(count > 1);
+	UTEST_ASSERT(written >= 64);
+
+	writer.write(Log::Message::deferred(Log::Level::Debug, "event %s", 1));
+	UTEST_ASSERT_EQUAL(size_t(0), pending());
+	writer.flush();
+	UTEST_ASSERT(pending() > 0);
+}
+
+UTEST_CASE(level_test)
+{
+	UTEST_ASSERT(Log::MinLevel == Log::Level::Debug);
+	UTEST_ASSERT_EQUAL(std::string("warning"), to_string(Log::Level::Warning));
+}
+
+}}
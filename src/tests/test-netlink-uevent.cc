@@ -0,0 +1,165 @@
+#include "utest/macros.h"
+
+#include "netlink/uevent.h"
+
+#include <endian.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace unittests {
+namespace netlink_uevent {
+
+using namespace std::string_literals;
+
+auto const KernelBind =
+	"bind@/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0\0"
+	"ACTION=bind\0"
+	"DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0\0"
+	"SUBSYSTEM=usb\0"
+	"DEVTYPE=usb_interface\0"
+	"DRIVER=usbhid\0"
+	"PRODUCT=b0e/e44/120\0"
+	"SEQNUM=4424\0"s;
+
+auto const UdevProperties =
+	"ACTION=add\0"
+	"DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.3/sound/card1\0"
+	"SUBSYSTEM=sound\0"
+	"SEQNUM=4431\0"
+	"USEC_INITIALIZED=8114529\0"
+	"ID_VENDOR_ID=0b0e\0"s;
+
+std::string udev_message(std::string const& properties, std::string const& subsystem, std::string const& devtype = {})
+{
+	uint32_t header[10] = {};
+	std::memcpy(header, "libudev", 8);
+	header[2] = htobe32(0xfeedcafe);
+	header[3] = sizeof(header);
+	header[4] = sizeof(header);
+	header[5] = uint32_t(properties.size());
+	header[6] = htobe32(Netlink::UEventFilter::hash(subsystem));
+	header[7] = devtype.empty() ? 0 : htobe32(Netlink::UEventFilter::hash(devtype));
+
+	return std::string(reinterpret_cast<char const*>(header), sizeof(header)) + properties;
+}
+
+UTEST_CASE(kernel_test)
+{
+	auto ev = Netlink::UEvent::parse(KernelBind);
+
+	UTEST_ASSERT(ev.has_value());
+	UTEST_ASSERT(ev->source() == Netlink::UEvent::Source::Kernel);
+	UTEST_ASSERT(ev->action() == "bind");
+	UTEST_ASSERT(ev->devpath() == "/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0");
+	UTEST_ASSERT(ev->subsystem() == "usb");
+	UTEST_ASSERT(ev->devtype() == "usb_interface");
+	UTEST_ASSERT_EQUAL(uint64_t(4424), ev->seqnum());
+	UTEST_ASSERT(ev->get("DRIVER") == "usbhid");
+	UTEST_ASSERT(ev->get("MODALIAS").empty());
+}
+
+UTEST_CASE(zero_copy_test)
+{
+	auto ev = Netlink::UEvent::parse(KernelBind);
+
+	UTEST_ASSERT(ev.has_value());
+	UTEST_ASSERT(ev->subsystem().data() > KernelBind.data());
+	UTEST_ASSERT(ev->subsystem().data() < KernelBind.data() + KernelBind.size());
+}
+
+UTEST_CASE(properties_test)
+{
+	auto ev = Netlink::UEvent::parse(KernelBind);
+
+	auto keys = std::vector<std::string_view>{};
+	for (auto const& [key, value] : *ev) {
+		keys.push_back(key);
+	}
+
+	UTEST_ASSERT_EQUAL(size_t(7), keys.size());
+	UTEST_ASSERT(keys.front() == "ACTION");
+	UTEST_ASSERT(keys.back() == "SEQNUM");
+}
+
+UTEST_CASE(udev_test)
+{
+	auto msg = udev_message(UdevProperties, "sound");
+	auto ev = Netlink::UEvent::parse(msg);
+
+	UTEST_ASSERT(ev.has_value());
+	UTEST_ASSERT(ev->source() == Netlink::UEvent::Source::Udev);
+	UTEST_ASSERT(ev->action() == "add");
+	UTEST_ASSERT(ev->subsystem() == "sound");
+	UTEST_ASSERT(ev->devtype().empty());
+	UTEST_ASSERT_EQUAL(uint64_t(4431), ev->seqnum());
+	UTEST_ASSERT(ev->get("ID_VENDOR_ID") == "0b0e");
+}
+
+UTEST_CASE(malformed_test)
+{
+	UTEST_ASSERT(!Netlink::UEvent::parse(""));
+	// not NUL terminated
+	UTEST_ASSERT(!Netlink::UEvent::parse(KernelBind.substr(0, KernelBind.size() - 1)));
+	// no ACTION@DEVPATH header
+	UTEST_ASSERT(!Netlink::UEvent::parse("ACTION=add\0DEVPATH=/x\0SUBSYSTEM=usb\0"s));
+	// SUBSYSTEM missing
+	UTEST_ASSERT(!Netlink::UEvent::parse("add@/x\0ACTION=add\0DEVPATH=/x\0"s));
+	UTEST_ASSERT(!Netlink::UEvent::parse("add@/x\0ACTION=add\0DEVPATH=/x\0SUBSYSTEM=usb\0SEQNUM=12a\0"s));
+
+	auto msg = udev_message(UdevProperties, "sound");
+	// properties beyond the datagram
+	UTEST_ASSERT(!Netlink::UEvent::parse(msg.substr(0, msg.size() - 2) + "\0"s));
+
+	auto bad_magic = msg;
+	bad_magic[8] = 0;
+	UTEST_ASSERT(!Netlink::UEvent::parse(bad_magic));
+}
+
+UTEST_CASE(filter_test)
+{
+	auto filter = Netlink::UEventFilter{};
+	UTEST_ASSERT(filter.empty());
+	UTEST_ASSERT(Netlink::UEvent::parse(KernelBind, filter));
+
+	filter.add_match_subsystem_devtype("sound");
+	UTEST_ASSERT(!Netlink::UEvent::parse(KernelBind, filter));
+	UTEST_ASSERT(Netlink::UEvent::parse(udev_message(UdevProperties, "sound"), filter));
+
+	filter.add_match_subsystem_devtype("usb", "usb_device");
+	UTEST_ASSERT(!Netlink::UEvent::parse(KernelBind, filter));
+
+	filter.add_match_subsystem_devtype("usb", "usb_interface");
+	UTEST_ASSERT(Netlink::UEvent::parse(KernelBind, filter));
+}
+
+UTEST_CASE(filter_hashes_test)
+{
+	auto filter = Netlink::UEventFilter{};
+	filter.add_match_subsystem_devtype("hidraw");
+
+	// rejected by the header alone, although the properties would match
+	auto msg = udev_message("ACTION=add\0DEVPATH=/x\0SUBSYSTEM=hidraw\0"s, "sound");
+	UTEST_ASSERT(Netlink::UEvent::parse(msg));
+	UTEST_ASSERT(!Netlink::UEvent::parse(msg, filter));
+
+	// a hash match is confirmed against the properties
+	msg = udev_message("ACTION=add\0DEVPATH=/x\0SUBSYSTEM=sound\0"s, "hidraw");
+	UTEST_ASSERT(!Netlink::UEvent::parse(msg, filter));
+}
+
+UTEST_CASE(hash_test)
+{
+	// Known answers of libudev's string_hash32() (MurmurHash2, seed 0),
+	// read from the socket filter udev_monitor_filter_update() installs.
+	// Any difference filters out every udevd message.
+	UTEST_ASSERT_EQUAL(uint32_t(0), Netlink::UEventFilter::hash(""));
+	UTEST_ASSERT_EQUAL(uint32_t(0x0577c5e5), Netlink::UEventFilter::hash("usb"));
+	UTEST_ASSERT_EQUAL(uint32_t(0xd196ab6e), Netlink::UEventFilter::hash("sound"));
+	UTEST_ASSERT_EQUAL(uint32_t(0x27f8f50c), Netlink::UEventFilter::hash("usb_device"));
+	UTEST_ASSERT_EQUAL(uint32_t(0xc2caf397), Netlink::UEventFilter::hash("hidraw"));
+	UTEST_ASSERT_EQUAL(uint32_t(0xc1a28470), Netlink::UEventFilter::hash("input"));
+}
+
+}}
@@ -92,4 +92,25 @@ UTEST_CASE_WITH_FIXTURE(parse_chunks_test, Fixture)
 	UTEST_ASSERT_EQUAL(IO::StreamBuffer::End, stream.get());
 }
 
+UTEST_CASE_WITH_FIXTURE(reset_test, Fixture)
+{
+	std::string res;
+
+	auto netstr = std::string_view("13:Hello");
+	buf.reserve(netstr.size());
+	netstr.copy(static_cast<char *>(buf.wstart()), netstr.size());
+	buf.fill(netstr.size());
+	UTEST_ASSERT_EQUAL(false, ns_reader.parse(res));
+
+	buf.drain(buf.rsize());
+	ns_reader.reset();
+
+	netstr = std::string_view("2:Hi,");
+	buf.reserve(netstr.size());
+	netstr.copy(static_cast<char *>(buf.wstart()), netstr.size());
+	buf.fill(netstr.size());
+	UTEST_ASSERT(ns_reader.parse(res));
+	UTEST_ASSERT_EQUAL(std::string("Hi"), res);
+}
+
 }}
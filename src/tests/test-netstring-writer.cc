@@ -0,0 +1,33 @@
+#include "utest/macros.h"
+#include "netstring/writer.h"
+#include "netstring/reader.h"
+#include "io/buffer.h"
+#include "io/stream-buffer.h"
+
+namespace unittests {
+namespace netstring_writer {
+
+UTEST_CASE(simple_test)
+{
+	IO::Buffer buf;
+	Netstring::write(buf, "Hello, world!");
+	Netstring::write(buf, "");
+	UTEST_ASSERT_EQUAL(std::string("13:Hello, world!,0:,"),
+		std::string(static_cast<char *>(buf.rstart()), buf.rsize()));
+}
+
+UTEST_CASE(roundtrip_test)
+{
+	IO::Buffer buf;
+	IO::StreamBuffer stream{buf};
+	Netstring::Reader reader{stream};
+
+	auto str = std::string(10000, 'x');
+	Netstring::write(buf, str);
+
+	std::string res;
+	UTEST_ASSERT(reader.parse(res));
+	UTEST_ASSERT_EQUAL(str, res);
+}
+
+}}
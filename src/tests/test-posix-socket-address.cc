@@ -1,6 +1,9 @@
 #include "utest/macros.h"
 #include "posix/socket-address.h"
 #include "posix/inet-address.h"
+#include "posix/unix-address.h"
+
+#include <sys/socket.h>
 
 #include "utest/assertion-traits.h"
 
@@ -11,7 +14,7 @@ struct StringTrait<Posix::SocketAddress>
 {
 	static std::string to_string(Posix::SocketAddress const& addr)
 	{
-		return to_string(addr);
+		return Posix::to_string(addr);
 	}
 };
 
@@ -56,4 +59,39 @@ UTEST_CASE(to_string_test)
 	UTEST_ASSERT_EQUAL(std::string{"[fd20:a634:9cb5:77::1]:5678"}, to_string(Posix::SocketAddress{Posix::Inet::Address{"fd20:a634:9cb5:77::1"}, 5678}));
 }
 
+UTEST_CASE(unix_test)
+{
+	auto path = Posix::SocketAddress{Posix::Unix::Address{"/run/baresip.sock"}};
+	UTEST_ASSERT(path);
+	UTEST_ASSERT_EQUAL(AF_UNIX, path.family());
+	UTEST_ASSERT_EQUAL(std::string{"/run/baresip.sock"}, to_string(path));
+
+	auto abstract = Posix::SocketAddress{Posix::Unix::Address{"@baresip"}};
+	UTEST_ASSERT_EQUAL(AF_UNIX, abstract.family());
+	UTEST_ASSERT_EQUAL(std::string{"@baresip"}, to_string(abstract));
+	UTEST_ASSERT(abstract != path);
+	UTEST_ASSERT(abstract == Posix::SocketAddress{Posix::Unix::Address{"@baresip"}});
+
+	UTEST_ASSERT_THROW(Posix::SocketAddress{Posix::Unix::Address{std::string(200, 'x')}}, std::runtime_error);
+	UTEST_ASSERT_THROW(Posix::SocketAddress{Posix::Unix::Address{}}, std::runtime_error);
+}
+
+UTEST_CASE(parse_test)
+{
+	UTEST_ASSERT_EQUAL(Posix::SocketAddress(Posix::Inet::Address{"127.0.0.1"}, 4444),
+		Posix::parse_socket_address("127.0.0.1:4444"));
+	UTEST_ASSERT_EQUAL(Posix::SocketAddress(Posix::Inet::Address{"fd20:a634:9cb5:77::1"}, 5678),
+		Posix::parse_socket_address("[fd20:a634:9cb5:77::1]:5678"));
+	UTEST_ASSERT_EQUAL(Posix::SocketAddress(Posix::Unix::Address{"/run/baresip.sock"}),
+		Posix::parse_socket_address("/run/baresip.sock"));
+	UTEST_ASSERT_EQUAL(Posix::SocketAddress(Posix::Unix::Address{"@baresip"}),
+		Posix::parse_socket_address("@baresip"));
+	UTEST_ASSERT_EQUAL(AF_UNSPEC, Posix::SocketAddress{}.family());
+
+	UTEST_ASSERT_THROW(Posix::parse_socket_address(""), std::runtime_error);
+	UTEST_ASSERT_THROW(Posix::parse_socket_address("127.0.0.1"), std::runtime_error);
+	UTEST_ASSERT_THROW(Posix::parse_socket_address("127.0.0.1:"), std::runtime_error);
+	UTEST_ASSERT_THROW(Posix::parse_socket_address("127.0.0.1:70000"), std::runtime_error);
+}
+
 }}
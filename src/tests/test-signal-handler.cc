@@ -0,0 +1,76 @@
+#include "utest/macros.h"
+
+#include "signal-handler.h"
+#include "posix/signal.h"
+
+#include <csignal>
+#include <unistd.h>
+
+namespace unittests {
+namespace signal_handler {
+
+class Fixture {
+public:
+	Fixture()
+	:
+		poller{EPoll::CtrlFactory::create()->make_ctrl()},
+		signalfd_factory{Posix::SignalFdFactory::create()},
+		handler{*poller, *signalfd_factory, {Posix::Signal::Usr1, Posix::Signal::Usr2}}
+	{
+		handler.on_signal(Posix::Signal::Usr1).connect([this](auto sig, auto const& info) {
+			received.emplace_back(sig, info.pid);
+		});
+		handler.on_signal(Posix::Signal::Usr2).connect([this](auto sig, auto const& info) {
+			received.emplace_back(sig, info.pid);
+		});
+	}
+
+	std::unique_ptr<EPoll::Ctrl> poller;
+	std::unique_ptr<Posix::SignalFdFactory> signalfd_factory;
+	SignalHandler handler;
+	std::vector<std::tuple<Posix::Signal, int>> received;
+};
+
+UTEST_CASE_WITH_FIXTURE(no_signal_test, Fixture)
+{
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT(received.empty());
+}
+
+UTEST_CASE_WITH_FIXTURE(batched_signals_test, Fixture)
+{
+	::kill(::getpid(), SIGUSR1);
+	::kill(::getpid(), SIGUSR2);
+
+	UTEST_ASSERT(poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT_EQUAL(size_t(2), received.size());
+	UTEST_ASSERT(std::get<0>(received[0]) == Posix::Signal::Usr1);
+	UTEST_ASSERT_EQUAL(::getpid(), std::get<1>(received[0]));
+	UTEST_ASSERT(std::get<0>(received[1]) == Posix::Signal::Usr2);
+
+	UTEST_ASSERT(!poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT_EQUAL(size_t(2), received.size());
+}
+
+UTEST_CASE_WITH_FIXTURE(unhandled_signal_test, Fixture)
+{
+	UTEST_ASSERT_THROW(handler.on_signal(Posix::Signal::Hup), std::runtime_error);
+}
+
+UTEST_CASE(unblock_test)
+{
+	auto poller = EPoll::CtrlFactory::create()->make_ctrl();
+	auto signalfd_factory = Posix::SignalFdFactory::create();
+
+	sigset_t mask;
+	{
+		SignalHandler handler{*poller, *signalfd_factory, {Posix::Signal::Usr1}};
+		::pthread_sigmask(SIG_BLOCK, nullptr, &mask);
+		UTEST_ASSERT(::sigismember(&mask, SIGUSR1));
+	}
+
+	::pthread_sigmask(SIG_BLOCK, nullptr, &mask);
+	UTEST_ASSERT(!::sigismember(&mask, SIGUSR1));
+}
+
+}}
@@ -2,6 +2,8 @@
 #include "signals.h"
 
 #include <map>
+#include <memory>
+#include <string>
 
 namespace unittests {
 namespace signal {
@@ -819,4 +821,95 @@ UTEST_CASE(test_signal1)
 	UTEST_ASSERT_EQUAL(43, res2);
 }
 
+UTEST_CASE(test_disconnect_copy_in_callback)
+{
+	Signal<void(void)> sig;
+	CallResult res;
+	auto conn1(sig.connect(res.fn()));
+	auto copy(conn1);
+
+	sig.connect([&conn1, &copy]() {
+		conn1.disconnect();
+		UTEST_ASSERT(!copy.connected());
+	});
+	sig();
+	UTEST_ASSERT(res.called);
+	UTEST_ASSERT_EQUAL(size_t(1), sig.slots());
+}
+
+UTEST_CASE(test_nested_emission)
+{
+	Signal<void(int)> sig;
+	size_t called{0};
+	Connection conn;
+	sig.connect([&](int depth) {
+		++called;
+		if (depth == 0) {
+			sig(1);
+			conn.disconnect();
+			sig(1);
+		}
+	});
+	conn = sig.connect([&called](int) { ++called; });
+
+	sig(0);
+	// outer, inner with both slots and inner with the first only,
+	// the outer emission skips the disconnected slot
+	UTEST_ASSERT_EQUAL(size_t(4), called);
+	UTEST_ASSERT_EQUAL(size_t(1), sig.slots());
+}
+
+UTEST_CASE(test_destroy_in_callback)
+{
+	auto sig = std::make_unique<Signal<void(void)>>();
+	CallResult res;
+	auto seen = std::string{};
+	// the heap allocated capture has to survive the reset
+	sig->connect([&sig, &seen, s = std::string(100, 'x')]() {
+		sig.reset();
+		seen = s;
+	});
+	sig->connect(res.fn());
+
+	(*sig)();
+	UTEST_ASSERT(!sig);
+	UTEST_ASSERT(!res.called);
+	UTEST_ASSERT_EQUAL(std::string(100, 'x'), seen);
+}
+
+UTEST_CASE(test_destroy_in_nested_callback)
+{
+	auto sig = std::make_unique<Signal<void(int)>>();
+	auto seen = std::string{};
+	Connection conn;
+	conn = sig->connect([&sig, &seen, &conn, s = std::make_unique<std::string>(100, 'x')](int depth) {
+		if (depth == 0) {
+			(*sig)(1);
+			// the signal is gone, but this closure is still alive
+			seen = *s;
+			conn.disconnect();
+		} else {
+			sig.reset();
+		}
+	});
+
+	(*sig)(0);
+	UTEST_ASSERT(!sig);
+	UTEST_ASSERT_EQUAL(std::string(100, 'x'), seen);
+	UTEST_ASSERT(!conn.connected());
+}
+
+UTEST_CASE(test_disconnect_moved_signal)
+{
+	Signal<void(void)> sig1;
+	CallResult res;
+	auto conn(sig1.connect(res.fn()));
+
+	Signal<void(void)> sig2(std::move(sig1));
+	conn.disconnect();
+	UTEST_ASSERT_EQUAL(size_t(0), sig2.slots());
+	sig2();
+	UTEST_ASSERT(!res.called);
+}
+
 }}
@@ -0,0 +1,66 @@
+#include "utest/macros.h"
+
+#include "spsc-ring.h"
+
+#include <thread>
+
+namespace unittests {
+namespace spsc_ring {
+
+UTEST_CASE(capacity_test)
+{
+	UTEST_ASSERT_EQUAL(size_t(1), SpscRing<int>(0).capacity());
+	UTEST_ASSERT_EQUAL(size_t(4), SpscRing<int>(3).capacity());
+	UTEST_ASSERT_EQUAL(size_t(8), SpscRing<int>(8).capacity());
+}
+
+UTEST_CASE(push_pop_test)
+{
+	auto ring = SpscRing<std::string>(2);
+	UTEST_ASSERT(ring.empty());
+	UTEST_ASSERT(!ring.try_pop());
+
+	UTEST_ASSERT(ring.try_push("a"));
+	UTEST_ASSERT(ring.try_push("b"));
+	UTEST_ASSERT(!ring.try_push("c"));
+	UTEST_ASSERT(!ring.empty());
+
+	// wrap around
+	for (auto next : {"c", "d", "e"}) {
+		UTEST_ASSERT(ring.try_pop().has_value());
+		UTEST_ASSERT(ring.try_push(next));
+	}
+
+	UTEST_ASSERT_EQUAL(std::string("d"), *ring.try_pop());
+	UTEST_ASSERT_EQUAL(std::string("e"), *ring.try_pop());
+	UTEST_ASSERT(ring.empty());
+}
+
+UTEST_CASE(threaded_test)
+{
+	auto ring = SpscRing<uint64_t>(64);
+	constexpr uint64_t Count = 100000;
+
+	auto producer = std::thread{[&ring] () {
+		for (uint64_t n{1}; n <= Count; ++n) {
+			while (!ring.try_push(uint64_t(n))) {
+				std::this_thread::yield();
+			}
+		}
+	}};
+
+	uint64_t expected{1};
+	bool ordered{true};
+	while (expected <= Count) {
+		if (auto n = ring.try_pop()) {
+			ordered = ordered && *n == expected;
+			++expected;
+		}
+	}
+	producer.join();
+
+	UTEST_ASSERT(ordered);
+	UTEST_ASSERT(ring.empty());
+}
+
+}}
@@ -0,0 +1,71 @@
+#include "utest/macros.h"
+
+#include "static-signal.h"
+#include "signals.h"
+
+#include <string>
+
+namespace unittests {
+namespace static_signal {
+
+namespace {
+
+class Counter {
+public:
+	void add(int n)
+	{
+		sum += n;
+	}
+
+	bool positive(int n) const
+	{
+		return n > 0;
+	}
+
+	int sum = 0;
+};
+
+}
+
+UTEST_CASE(order_test)
+{
+	std::string order;
+	auto sig = StaticSignal{
+		[&order] (int n) { order += "a" + std::to_string(n); },
+		[&order] (int n) { order += "b" + std::to_string(n); }};
+
+	sig(1);
+	sig(2);
+	UTEST_ASSERT_EQUAL(std::string("a1b1a2b2"), order);
+}
+
+UTEST_CASE(filter_test)
+{
+	Counter counter;
+	auto sig = StaticSignal{
+		member_slot<&Counter::positive>(counter),
+		member_slot<&Counter::add>(counter)};
+
+	sig(3);
+	sig(-5);
+	sig(4);
+	UTEST_ASSERT_EQUAL(7, counter.sum);
+}
+
+UTEST_CASE(dynamic_test)
+{
+	Counter counter;
+	auto sig = StaticSignal{member_slot<&Counter::add>(counter)};
+
+	Signal<void(int)> dynamic;
+	auto conn = AutoConnection{dynamic.connect(std::ref(sig))};
+	dynamic(2);
+	dynamic(3);
+	UTEST_ASSERT_EQUAL(5, counter.sum);
+
+	auto forward = StaticSignal{std::ref(dynamic)};
+	forward(1);
+	UTEST_ASSERT_EQUAL(6, counter.sum);
+}
+
+}}
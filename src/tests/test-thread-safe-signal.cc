@@ -0,0 +1,106 @@
+#include "utest/macros.h"
+
+#include "thread-safe-signal.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace unittests {
+namespace thread_safe_signal {
+
+class Fixture {
+public:
+	std::unique_ptr<EPoll::Ctrl> poller{EPoll::CtrlFactory::create()->make_ctrl()};
+	ThreadSafeSignal<void(std::string const&, int)> sig;
+};
+
+UTEST_CASE_WITH_FIXTURE(direct_test, Fixture)
+{
+	std::string seen;
+	auto conn = sig.connect([&seen](std::string const& s, int n) { seen = s + std::to_string(n); });
+	UTEST_ASSERT_EQUAL(size_t(1), sig.slots());
+
+	sig("a", 1);
+	UTEST_ASSERT_EQUAL(std::string("a1"), seen);
+
+	conn.disconnect();
+	UTEST_ASSERT(!conn.connected());
+	UTEST_ASSERT_EQUAL(size_t(0), sig.slots());
+
+	sig("b", 2);
+	UTEST_ASSERT_EQUAL(std::string("a1"), seen);
+}
+
+UTEST_CASE_WITH_FIXTURE(queued_test, Fixture)
+{
+	auto loop_thread = std::this_thread::get_id();
+	std::string seen;
+	bool same_thread{false};
+	auto conn = AutoConnection{sig.connect([&](std::string const& s, int n) {
+		same_thread = std::this_thread::get_id() == loop_thread;
+		seen += s + std::to_string(n);
+	}, *poller)};
+
+	auto worker = std::thread{[this] () {
+		// the argument is copied, the temporary is gone before delivery
+		sig(std::string("a"), 1);
+		sig(std::string("b"), 2);
+	}};
+	worker.join();
+	UTEST_ASSERT(seen.empty());
+
+	UTEST_ASSERT(poller->wait());
+	UTEST_ASSERT(same_thread);
+	UTEST_ASSERT_EQUAL(std::string("a1b2"), seen);
+}
+
+UTEST_CASE_WITH_FIXTURE(disconnect_queued_test, Fixture)
+{
+	size_t called{0};
+	auto conn = sig.connect([&called](std::string const&, int) { ++called; }, *poller);
+
+	sig("a", 1);
+	conn.disconnect();
+
+	UTEST_ASSERT(poller->wait(std::chrono::milliseconds(0)));
+	UTEST_ASSERT_EQUAL(size_t(0), called);
+}
+
+UTEST_CASE_WITH_FIXTURE(concurrent_test, Fixture)
+{
+	std::atomic<size_t> called{0};
+	auto conn = AutoConnection{sig.connect([&called](std::string const&, int) { ++called; })};
+
+	auto workers = std::vector<std::thread>{};
+	for (size_t w{0}; w < 4; ++w) {
+		workers.emplace_back([this] () {
+			for (int n{0}; n < 1000; ++n) {
+				sig("x", n);
+			}
+		});
+	}
+
+	// churn the slot list while the workers emit
+	for (size_t n{0}; n < 1000; ++n) {
+		auto tmp = AutoConnection{sig.connect([](std::string const&, int) { })};
+	}
+
+	for (auto & worker : workers) {
+		worker.join();
+	}
+	UTEST_ASSERT_EQUAL(size_t(4000), called.load());
+	UTEST_ASSERT_EQUAL(size_t(1), sig.slots());
+}
+
+UTEST_CASE(destroyed_signal_test)
+{
+	auto sig = std::make_unique<ThreadSafeSignal<void()>>();
+	auto conn = sig->connect([] () { });
+	sig.reset();
+
+	UTEST_ASSERT(!conn.connected());
+	conn.disconnect();
+}
+
+}}
@@ -0,0 +1,125 @@
+#include "utest/macros.h"
+
+#include "udev-device-snapshot.h"
+
+#include <sys/sysmacros.h>
+
+#include <utility>
+
+namespace unittests {
+namespace udev_device_snapshot {
+
+using Field = UDev::DeviceSnapshot::Field;
+using List = UDev::DeviceSnapshot::List;
+
+UDev::DeviceSnapshot make_usb_device()
+{
+	return UDev::DeviceSnapshot::Builder{}
+		.set(Field::Devpath, "/devices/pci0000:00/0000:00:14.0/usb1/1-2")
+		.set(Field::Subsystem, "usb")
+		.set(Field::Devtype, "usb_device")
+		.set(Field::Sysname, "1-2")
+		.set(Field::Driver, "")
+		.add(List::Properties, "ID_VENDOR_ID", "0b0e")
+		.add(List::Properties, "DEVTYPE", "usb_device")
+		.add(List::Properties, "ID_MODEL_ID", "0348")
+		.add(List::Properties, "DEVTYPE", "shadowed")
+		.add(List::Tags, "seat")
+		.add(List::Tags, "uaccess")
+		.add(List::Sysattr, "idVendor")
+		.is_initialized(true)
+		.devnum(makedev(189, 1))
+		.seqnum(4711)
+		.build();
+}
+
+UTEST_CASE(fields_test)
+{
+	auto dev = make_usb_device();
+
+	UTEST_ASSERT(dev.devpath() == "/devices/pci0000:00/0000:00:14.0/usb1/1-2");
+	UTEST_ASSERT(dev.subsystem() == "usb");
+	UTEST_ASSERT(dev.devtype() == "usb_device");
+	UTEST_ASSERT(dev.sysname() == "1-2");
+	UTEST_ASSERT(dev.has(Field::Sysname));
+
+	UTEST_ASSERT(dev.has(Field::Driver));
+	UTEST_ASSERT(dev.driver().empty());
+	UTEST_ASSERT(!dev.has(Field::Devnode));
+	UTEST_ASSERT(dev.devnode().empty());
+
+	UTEST_ASSERT(dev.is_initialized());
+	UTEST_ASSERT(dev.devnum() == makedev(189, 1));
+	UTEST_ASSERT_EQUAL(4711ULL, dev.seqnum());
+	UTEST_ASSERT_EQUAL(0ULL, dev.usec_since_initialized());
+}
+
+UTEST_CASE(lists_test)
+{
+	auto dev = make_usb_device();
+
+	auto props = dev.properties();
+	UTEST_ASSERT_EQUAL(size_t(3), props.size());
+	UTEST_ASSERT(props.begin()[0].first == "DEVTYPE");
+	UTEST_ASSERT(props.begin()[1].first == "ID_MODEL_ID");
+	UTEST_ASSERT(props.begin()[2].first == "ID_VENDOR_ID");
+
+	// the first value wins like in a std::map
+	UTEST_ASSERT(dev.property_value("DEVTYPE") == "usb_device");
+	UTEST_ASSERT(dev.property_value("ID_VENDOR_ID") == "0b0e");
+	UTEST_ASSERT(dev.property_value("MISSING").empty());
+	UTEST_ASSERT(!props.contains("seat"));
+
+	UTEST_ASSERT(dev.has_tag("seat"));
+	UTEST_ASSERT(dev.has_tag("uaccess"));
+	UTEST_ASSERT(!dev.has_tag("usb"));
+	UTEST_ASSERT(!dev.has_current_tag("seat"));
+
+	UTEST_ASSERT(dev.devlinks().empty());
+	UTEST_ASSERT(dev.current_tags().empty());
+	UTEST_ASSERT_EQUAL(size_t(1), dev.sysattr().size());
+	UTEST_ASSERT(dev.sysattr().contains("idVendor"));
+}
+
+UTEST_CASE(to_map_test)
+{
+	auto dev = make_usb_device();
+
+	auto props = dev.properties().to_map();
+	UTEST_ASSERT_EQUAL(size_t(3), props.size());
+	UTEST_ASSERT_EQUAL(std::string("0348"), props["ID_MODEL_ID"]);
+	UTEST_ASSERT_EQUAL(std::string(""), dev.tags().to_map()["seat"]);
+}
+
+UTEST_CASE(move_test)
+{
+	auto dev = make_usb_device();
+	auto moved = std::move(dev);
+
+	UTEST_ASSERT(moved.subsystem() == "usb");
+	UTEST_ASSERT(moved.property_value("ID_MODEL_ID") == "0348");
+}
+
+UTEST_CASE(empty_test)
+{
+	auto dev = UDev::DeviceSnapshot::Builder{}.build();
+
+	UTEST_ASSERT(!dev.has(Field::Devpath));
+	UTEST_ASSERT(dev.properties().empty());
+	UTEST_ASSERT(dev.property_value("DEVTYPE").empty());
+	UTEST_ASSERT(!dev.is_initialized());
+}
+
+UTEST_CASE(builder_reuse_test)
+{
+	auto builder = UDev::DeviceSnapshot::Builder{};
+	auto first = builder.set(Field::Subsystem, "usb").add(List::Tags, "seat").build();
+	auto second = builder.set(Field::Subsystem, "tty").build();
+
+	UTEST_ASSERT(first.subsystem() == "usb");
+	UTEST_ASSERT(first.has_tag("seat"));
+	UTEST_ASSERT(second.subsystem() == "tty");
+	UTEST_ASSERT(!second.has_tag("seat"));
+}
+
+}}
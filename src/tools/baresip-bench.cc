@@ -0,0 +1,186 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "baresip-stub.h"
+#include "baresip/ctrl.h"
+#include "baresip/model.h"
+#include "buffered-stream-socket.h"
+#include "epoll/ctrl.h"
+#include "histogram.h"
+#include "posix/socket.h"
+#include "posix/socket-address.h"
+#include "posix/timer-fd.h"
+#include "posix/unix-address.h"
+#include "fmt.h"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+
+#include <unistd.h>
+
+namespace {
+
+struct Options {
+	uint64_t events = 100000;
+	// events per second, 0 sends as fast as the window allows
+	uint64_t rate = 0;
+	// events in flight when running without a rate
+	uint64_t window = 64;
+	// size of the param field of each event
+	size_t size = 64;
+	std::string address = "@clingeling-bench-" + std::to_string(::getpid());
+};
+
+Options parse_options(int argc, char *argv[])
+{
+	auto res = Options{};
+	int opt;
+	while ((opt = ::getopt(argc, argv, "n:r:w:s:a:")) != -1) {
+		switch (opt) {
+		case 'n':
+			res.events = std::stoull(optarg);
+			break;
+		case 'r':
+			res.rate = std::stoull(optarg);
+			break;
+		case 'w':
+			res.window = std::max(std::stoull(optarg), 1ULL);
+			break;
+		case 's':
+			res.size = std::stoull(optarg);
+			break;
+		case 'a':
+			res.address = optarg;
+			break;
+		default:
+			throw std::runtime_error(FMT_FORMAT(
+				"usage: %s [-n events] [-r rate] [-w window] [-s size] [-a address]", argv[0]));
+		}
+	}
+	return res;
+}
+
+uint64_t now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Each call goes through incoming, established and closed, so the model
+// sees new, changed and closed calls in equal shares. The param carries
+// the send time for the latency measurement, padded to the event size.
+Json::Object make_event(uint64_t n, size_t size)
+{
+	static constexpr std::array<char const*, 3> types{
+		"CALL_INCOMING", "CALL_ESTABLISHED", "CALL_CLOSED"};
+
+	auto param = std::to_string(now());
+	if (param.size() < size) {
+		param.append(size - param.size(), 'x');
+	}
+
+	return Json::make_object({
+		{"event", true},
+		{"class", "call"},
+		{"type", types[n % types.size()]},
+		{"accountaor", "sip:9999-1@asterisk.example.com"},
+		{"direction", "incoming"},
+		{"peeruri", "sip:7777@192.168.55.1:5060"},
+		{"id", std::to_string(n / types.size())},
+		{"param", param},
+	});
+}
+
+// strips the padding from the param
+uint64_t sent_at(Baresip::Event::Any const& ev)
+{
+	auto const& param = std::get<Baresip::Event::Call>(ev).param;
+	return std::stoull(param.substr(0, param.find('x')));
+}
+
+}
+
+// Drives the whole control path, stub -> BufferedStreamSocket ->
+// Netstring::Reader -> Json parser -> Baresip::Ctrl -> Baresip::Model,
+// in one event loop and reports throughput and latency.
+int main(int argc, char *argv[])
+{
+	try {
+		auto options = parse_options(argc, argv);
+
+		auto poller = EPoll::CtrlFactory::create()->make_ctrl();
+		auto socket_factory = Posix::SocketFactory::create();
+		auto timerfd_factory = Posix::TimerFdFactory::create();
+		auto addr = Posix::parse_socket_address(options.address);
+
+		auto stub = BaresipStub(*poller, *socket_factory, addr);
+		auto sock = BufferedStreamSocket(*poller, *socket_factory, *timerfd_factory, addr);
+		auto ctrl = Baresip::Ctrl::create(sock.recvbuf(), sock.sendbuf());
+		auto model = Baresip::Model::create();
+		connect(model->on_event, ctrl->on_event);
+
+		sock.on_disconnect.connect([] (auto const& reason) {
+			throw std::runtime_error("connection lost: " + reason);
+		});
+
+		uint64_t sent{0};
+		uint64_t received{0};
+		auto latency = Histogram{};
+		auto send = [&] (uint64_t count) {
+			for (; count && sent < options.events; --count) {
+				stub.send(make_event(sent++, options.size));
+			}
+		};
+
+		// model is connected first, so this runs after the model
+		// has processed the event
+		ctrl->on_event.connect([&] (auto const& ev) {
+			latency.record(now() - sent_at(ev));
+			++received;
+			if (options.rate == 0) {
+				send(1);
+			}
+		});
+
+		while (stub.clients() == 0 || sock.state() != BufferedStreamSocket::State::connected) {
+			poller->wait(std::chrono::milliseconds(100));
+		}
+
+		auto timer = timerfd_factory->make_timerfd(Posix::Fd::Option::nonblock|Posix::Fd::Option::cloexec);
+		auto start = std::chrono::steady_clock::now();
+		if (options.rate == 0) {
+			send(options.window);
+		} else {
+			poller->add(timer, EPoll::Events{EPoll::Event::In}, [&] (auto const&) {
+				timer->expirations();
+				auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+				auto due = std::min(uint64_t(elapsed.count() * options.rate), options.events);
+				send(due > sent ? due - sent : 0);
+			});
+			timer->set(std::chrono::milliseconds(1), std::chrono::milliseconds(1));
+		}
+
+		while (received < options.events) {
+			poller->wait();
+		}
+		auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+		if (options.rate != 0) {
+			poller->del(timer);
+		}
+
+		std::cout
+			<< "events: " << received << "\n"
+			<< "elapsed: " << elapsed.count() << "s\n"
+			<< "throughput: " << uint64_t(received / elapsed.count()) << " events/s\n"
+			<< "latency ns: " << to_string(latency) << "\n";
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << "\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "baresip/event-filter.h"
+#include "baresip/journal.h"
+#include "baresip/model.h"
+#include "posix/system-error.h"
+#include "static-signal.h"
+
+#include <chrono>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// read only mapping of a whole file
+class MappedFile {
+public:
+	explicit MappedFile(std::string const& path)
+	{
+		int fd = ::open(path.c_str(), O_RDONLY|O_CLOEXEC);
+		if (fd < 0) {
+			throw POSIX_SYSTEM_ERROR("open(%s)", path);
+		}
+
+		struct stat st;
+		if (::fstat(fd, &st) != 0) {
+			auto err = POSIX_SYSTEM_ERROR("fstat(%s)", path);
+			::close(fd);
+			throw err;
+		}
+
+		size_ = st.st_size;
+		if (size_ != 0) {
+			addr_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		::close(fd);
+		if (addr_ == MAP_FAILED) {
+			throw POSIX_SYSTEM_ERROR("mmap(%s)", path);
+		}
+	}
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile & operator=(MappedFile const&) = delete;
+
+	~MappedFile()
+	{
+		if (addr_ != nullptr && addr_ != MAP_FAILED) {
+			::munmap(addr_, size_);
+		}
+	}
+
+	std::string_view data() const
+	{
+		return {static_cast<char const*>(addr_), size_};
+	}
+
+private:
+	void *addr_ = nullptr;
+	size_t size_ = 0;
+};
+
+void backtrace(std::exception const& e)
+{
+	std::cerr << e.what() << "\n";
+	try {
+		std::rethrow_if_nested(e);
+	} catch (std::exception const& e) {
+		backtrace(e);
+	}
+}
+
+}
+
+// Feed a journal recorded by clingeling -j through the event filter
+// and the model as fast as possible.
+int main(int argc, char *argv[])
+{
+	if (argc != 2) {
+		std::cerr << "usage: " << argv[0] << " <journal>\n";
+		return 1;
+	}
+
+	try {
+		auto file = MappedFile(argv[1]);
+		auto reader = Baresip::Journal::Reader(file.data());
+
+		auto filter = Baresip::EventFilter::create();
+		auto model = Baresip::Model::create();
+		auto pipeline = StaticSignal{
+			member_slot<&Baresip::EventFilter::pass>(*filter),
+			member_slot<&Baresip::Model::handle>(*model)};
+
+		uint64_t count{0};
+		auto record = Baresip::Journal::Record{};
+		auto start = std::chrono::steady_clock::now();
+		while (reader.next(record)) {
+			pipeline(record.event);
+			++count;
+		}
+		auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+		std::cout
+			<< "events: " << count << "\n"
+			<< "elapsed: " << elapsed.count() << "s\n"
+			<< "rate: " << (elapsed.count() > 0 ? count / elapsed.count() : 0.0) << " events/s\n"
+			<< "filter: " << to_string(filter->stats()) << "\n"
+			<< "open calls: " << model->calls().size() << "\n"
+			<< "accounts: " << model->accounts().size() << "\n";
+	} catch (std::exception const& e) {
+		::backtrace(e);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+#include "log/binary.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Print a binary log written by Log::Binary::Writer as text.
+int main(int argc, char *argv[])
+{
+	if (argc != 2) {
+		std::cerr << "usage: " << argv[0] << " <log>\n";
+		return 1;
+	}
+
+	try {
+		auto file = std::ifstream(argv[1], std::ios::binary);
+		if (!file) {
+			std::cerr << "failed to open " << argv[1] << "\n";
+			return 1;
+		}
+		auto data = std::ostringstream{};
+		data << file.rdbuf();
+		auto content = data.str();
+
+		auto reader = Log::Binary::Reader(content);
+		auto level = Log::Level::Info;
+		auto text = std::string{};
+		while (reader.next(level, text)) {
+			std::cout << to_string(level) << ": " << text << "\n";
+		}
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << "\n";
+		return 1;
+	}
+
+	return 0;
+}
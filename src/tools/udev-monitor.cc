@@ -2,14 +2,17 @@
 #include "source-location.h"
 
 #include "netlink/socket.h"
+#include "netlink/uevent.h"
 #include "posix/system-error.h"
 
+#include <array>
 #include <iostream>
-#include <cctype>
+#include <string_view>
 
 namespace {
 
-void on_netlink_event(EPoll::Events const& ev, std::shared_ptr<Netlink::Socket> const& socket)
+void on_netlink_event(EPoll::Events const& ev, std::shared_ptr<Netlink::Socket> const& socket,
+		Netlink::UEventFilter const& filter)
 {
 	if (ev != EPoll::Event::In) {
 		auto ec = socket->get_socket_error();
@@ -19,27 +22,25 @@ void on_netlink_event(EPoll::Events const& ev, std::shared_ptr<Netlink::Socket>
 	auto buf = std::array<char, 8192>{};
 	auto size = socket->read(buf.data(), buf.size());
 
-	if (size == buf.size() || size < 5) {
+	if (size == buf.size()) {
 		return;
 	}
 
-	auto end = std::begin(buf) + size;
-	if (*std::prev(end) != '\0') {
+	auto uevent = Netlink::UEvent::parse(std::string_view(buf.data(), size), filter);
+	if (!uevent) {
 		return;
 	}
 
-	// bind@/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0.ACTION=bind.DEVPATH=/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2:1.0.SUBSYSTEM=usb.DEVTYPE=usb_interface.DRIVER=usbhid.PRODUCT=b0e/e44/120.TYPE=0/0/0.INTERFACE=3/0/0.MODALIAS=usb:v0B0Ep0E44d0120dc00dsc00dp00ic03isc00ip00in00.SEQNUM=4424.
+	std::cerr << uevent->seqnum() << " " << uevent->action() << " " << uevent->devpath()
+		<< " (" << uevent->subsystem();
+	if (!uevent->devtype().empty()) {
+		std::cerr << "/" << uevent->devtype();
+	}
+	std::cerr << ")\n";
 
-	for (auto i{0U}; i < size; ++i) {
-		if (buf[i] == '\0') {
-			buf[i] = '\n';
-		} else if (!std::isprint(buf[i])) {
-			buf[i] = '.';
-		}
+	for (auto const& [key, value] : *uevent) {
+		std::cerr << "    " << key << "=" << value << "\n";
 	}
-	std::cerr << "\n----- MESSAGE BEGIN -----\n";
-	std::cerr << buf.data();
-	std::cerr << "----- MESSAGE END -----\n";
 }
 
 void backtrace(std::exception const& e)
@@ -54,8 +55,20 @@ void backtrace(std::exception const& e)
 
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+	// arguments are subsystem[/devtype] matches
+	auto filter = Netlink::UEventFilter{};
+	for (int i{1}; i < argc; ++i) {
+		auto match = std::string_view(argv[i]);
+		auto slash = match.find('/');
+		if (slash == std::string_view::npos) {
+			filter.add_match_subsystem_devtype(match);
+		} else {
+			filter.add_match_subsystem_devtype(match.substr(0, slash), match.substr(slash + 1));
+		}
+	}
+
 	auto poller_factory = EPoll::CtrlFactory::create();
 	auto poller = poller_factory->make_ctrl();
 
@@ -66,7 +79,7 @@ int main()
 	netlink_socket->bind(0x0001);
 
 	poller->add(netlink_socket, EPoll::Events{EPoll::Event::In},
-			[&netlink_socket](auto const& ev) { ::on_netlink_event(ev, netlink_socket); });
+			[&netlink_socket, &filter](auto const& ev) { ::on_netlink_event(ev, netlink_socket, filter); });
 
 	try {
 		do {
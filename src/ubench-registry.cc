@@ -0,0 +1,32 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "ubench/registry.h"
+
+namespace UBench {
+
+Registry & Registry::get()
+{
+	static Registry instance{};
+	return instance;
+}
+
+void Registry::register_bench(std::string const& name, SourceLocation const& loc, std::function<void(State &)> const& run)
+{
+	benches_.push_back({name, loc, run});
+}
+
+Registry::const_iterator Registry::begin() const
+{
+	return benches_.begin();
+}
+
+Registry::const_iterator Registry::end() const
+{
+	return benches_.end();
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+   Copyright (c) 2021 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "ubench/runner.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace UBench {
+
+namespace {
+
+State run_once(Registry::Bench const& bench, uint64_t iterations)
+{
+	auto state = State{iterations};
+	bench.run(state);
+	return state;
+}
+
+}
+
+Result run(Registry::Bench const& bench, Params const& params)
+{
+	uint64_t iterations{1};
+	for (;;) {
+		auto elapsed = run_once(bench, iterations).elapsed();
+		if (elapsed >= params.min_time) {
+			break;
+		}
+
+		// aim a bit beyond min_time, but grow at most 100 fold
+		// per step as the first runs are noisy
+		auto factor = elapsed.count() > 0
+			? 1.2 * params.min_time.count() / elapsed.count()
+			: 100.0;
+		iterations = std::max(iterations + 1, uint64_t(iterations * std::min(factor, 100.0)));
+	}
+
+	auto ns = std::vector<double>{};
+	uint64_t bytes{0};
+	for (size_t i{0}; i < std::max(params.repetitions, size_t(1)); ++i) {
+		auto state = run_once(bench, iterations);
+		ns.push_back(double(state.elapsed().count()) / iterations);
+		bytes = state.bytes();
+	}
+	std::sort(begin(ns), end(ns));
+
+	auto res = Result{};
+	res.name = bench.name;
+	res.iterations = iterations;
+	res.repetitions = ns.size();
+	res.median_ns = ns[ns.size() / 2];
+	res.min_ns = ns.front();
+	res.max_ns = ns.back();
+	res.bytes_per_second = res.median_ns > 0 ? bytes * 1e9 / res.median_ns : 0.0;
+	return res;
+}
+
+}
@@ -0,0 +1,104 @@
+/*
+   Copyright (c) 2023 Andreas Fett. All rights reserved.
+   Use of this source code is governed by a BSD-style
+   license that can be found in the LICENSE file.
+*/
+
+#include "udev-device-snapshot.h"
+
+#include <algorithm>
+
+namespace UDev {
+
+DeviceSnapshot::Map::const_iterator DeviceSnapshot::Map::find(std::string_view key) const
+{
+	auto it = std::lower_bound(begin_, end_, key, [] (auto const& entry, auto const& key) {
+		return entry.first < key;
+	});
+	return it != end_ && it->first == key ? it : end_;
+}
+
+std::string_view DeviceSnapshot::Map::value(std::string_view key) const
+{
+	auto it = find(key);
+	return it != end_ ? it->second : std::string_view{};
+}
+
+std::map<std::string, std::string> DeviceSnapshot::Map::to_map() const
+{
+	auto res = std::map<std::string, std::string>{};
+	for (auto const& [key, value] : *this) {
+		res.emplace_hint(res.end(), key, value);
+	}
+	return res;
+}
+
+DeviceSnapshot::Builder::Ref DeviceSnapshot::Builder::append(std::string_view str)
+{
+	// every string is NUL terminated, which also keeps the arena from
+	// being empty so valid empty strings can be told from missing ones
+	auto ref = Ref{arena_.size(), str.size(), true};
+	arena_.append(str);
+	arena_.push_back('\0');
+	return ref;
+}
+
+DeviceSnapshot::Builder & DeviceSnapshot::Builder::set(Field field, std::string_view value)
+{
+	fields_[size_t(field)] = append(value);
+	return *this;
+}
+
+DeviceSnapshot::Builder & DeviceSnapshot::Builder::add(List list, std::string_view key, std::string_view value)
+{
+	entries_.push_back({list, append(key), append(value)});
+	return *this;
+}
+
+DeviceSnapshot DeviceSnapshot::Builder::build()
+{
+	auto res = std::move(snapshot_);
+	snapshot_ = DeviceSnapshot{};
+
+	res.arena_.assign(arena_.begin(), arena_.end());
+	auto view = [base = res.arena_.data()] (Ref const& ref) {
+		return ref.valid ? std::string_view(base + ref.offset, ref.size) : std::string_view{};
+	};
+
+	for (size_t i{0}; i < Fields; ++i) {
+		res.fields_[i] = view(fields_[i]);
+	}
+
+	auto key = [this] (EntryRef const& entry) {
+		return std::string_view(arena_.data() + entry.key.offset, entry.key.size);
+	};
+	// keys are appended in insertion order, so their offset keeps the
+	// first of several equal keys in front without a stable sort
+	std::sort(entries_.begin(), entries_.end(), [&key] (auto const& lhs, auto const& rhs) {
+		if (lhs.list != rhs.list) {
+			return lhs.list < rhs.list;
+		}
+		auto cmp = key(lhs).compare(key(rhs));
+		return cmp != 0 ? cmp < 0 : lhs.key.offset < rhs.key.offset;
+	});
+
+	res.entries_.reserve(entries_.size());
+	for (size_t i{0}; i < entries_.size(); ++i) {
+		auto const& entry = entries_[i];
+		auto & range = res.lists_[size_t(entry.list)];
+		if (range.first == range.second) {
+			range = {res.entries_.size(), res.entries_.size()};
+		} else if (entry.list == entries_[i - 1].list && key(entry) == key(entries_[i - 1])) {
+			continue;
+		}
+		res.entries_.emplace_back(view(entry.key), view(entry.value));
+		++range.second;
+	}
+
+	arena_.clear();
+	fields_ = {};
+	entries_.clear();
+	return res;
+}
+
+}
@@ -34,6 +34,62 @@ std::map<std::string, std::string> copy_udev_list(udev_list_entry *first_entry)
 	return res;
 }
 
+void add_udev_list(UDev::DeviceSnapshot::Builder & builder, UDev::DeviceSnapshot::List list, udev_list_entry *first_entry)
+{
+	auto list_entry = first_entry;
+	udev_list_entry_foreach(list_entry, first_entry) {
+		auto name = udev_list_entry_get_name(list_entry);
+		if (!name) {
+			continue;
+		}
+		auto value = udev_list_entry_get_value(list_entry);
+		builder.add(list, name, value ? value : "");
+	}
+}
+
+void set_field(UDev::DeviceSnapshot::Builder & builder, UDev::DeviceSnapshot::Field field, char const* value)
+{
+	if (value) {
+		builder.set(field, value);
+	}
+}
+
+UDev::DeviceSnapshot make_snapshot(udev_device *dev)
+{
+	using Field = UDev::DeviceSnapshot::Field;
+	using List = UDev::DeviceSnapshot::List;
+
+	auto initialized = udev_device_get_is_initialized(dev);
+	if (initialized < 0) {
+		throw Posix::make_system_error(-initialized, "%s: udev_device_get_is_initialized(%x)",
+				to_string(SourceLocation::current()), dev);
+	}
+
+	auto builder = UDev::DeviceSnapshot::Builder{};
+	set_field(builder, Field::Devpath, udev_device_get_devpath(dev));
+	set_field(builder, Field::Subsystem, udev_device_get_subsystem(dev));
+	set_field(builder, Field::Devtype, udev_device_get_devtype(dev));
+	set_field(builder, Field::Syspath, udev_device_get_syspath(dev));
+	set_field(builder, Field::Sysname, udev_device_get_sysname(dev));
+	set_field(builder, Field::Sysnum, udev_device_get_sysnum(dev));
+	set_field(builder, Field::Devnode, udev_device_get_devnode(dev));
+	set_field(builder, Field::Driver, udev_device_get_driver(dev));
+	set_field(builder, Field::Action, udev_device_get_action(dev));
+
+	add_udev_list(builder, List::Devlinks, udev_device_get_devlinks_list_entry(dev));
+	add_udev_list(builder, List::Properties, udev_device_get_properties_list_entry(dev));
+	add_udev_list(builder, List::Tags, udev_device_get_tags_list_entry(dev));
+	add_udev_list(builder, List::CurrentTags, udev_device_get_current_tags_list_entry(dev));
+	add_udev_list(builder, List::Sysattr, udev_device_get_sysattr_list_entry(dev));
+
+	return builder
+		.is_initialized(initialized > 0)
+		.devnum(udev_device_get_devnum(dev))
+		.seqnum(udev_device_get_seqnum(dev))
+		.usec_since_initialized(udev_device_get_usec_since_initialized(dev))
+		.build();
+}
+
 }
 
 namespace UDev {
@@ -73,8 +129,13 @@ public:
 	bool has_tag(std::string const& tag) const final;
 	bool has_current_tag(std::string const& tag) const final;
 
+	std::shared_ptr<DeviceSnapshot const> snapshot() const final;
+
 private:
 	unref_unique_ptr<udev_device> raw_;
+	// built by the first snapshot() call, the getters use it once it
+	// exists, the attributes of a udev_device never change
+	mutable std::shared_ptr<DeviceSnapshot const> snapshot_;
 };
 
 DeviceImpl::DeviceImpl(unref_unique_ptr<udev_device> raw)
@@ -117,7 +178,7 @@ std::string DeviceImpl::devpath() const
 {
 	auto res = udev_device_get_devpath(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_devpath(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_devpath(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -127,7 +188,7 @@ std::string DeviceImpl::subsystem() const
 {
 	auto res = udev_device_get_subsystem(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_subsystem(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_subsystem(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -137,7 +198,7 @@ std::string DeviceImpl::devtype() const
 {
 	auto res = udev_device_get_devtype(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_devtype(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_devtype(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -147,7 +208,7 @@ std::string DeviceImpl::syspath() const
 {
 	auto res = udev_device_get_syspath(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_syspath(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_syspath(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -157,7 +218,7 @@ std::string DeviceImpl::sysname() const
 {
 	auto res = udev_device_get_sysname(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_sysname(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_sysname(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -167,7 +228,7 @@ std::string DeviceImpl::sysnum() const
 {
 	auto res = udev_device_get_sysnum(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_sysnum(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_sysnum(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -177,7 +238,7 @@ std::string DeviceImpl::devnode() const
 {
 	auto res = udev_device_get_devnode(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_devnode(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_devnode(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -195,31 +256,49 @@ bool DeviceImpl::is_initialized() const
 
 std::map<std::string, std::string> DeviceImpl::devlinks() const
 {
+	if (snapshot_) {
+		return snapshot_->devlinks().to_map();
+	}
 	return copy_udev_list(udev_device_get_devlinks_list_entry(raw_.get()));
 }
 
 std::map<std::string, std::string> DeviceImpl::properties() const
 {
+	if (snapshot_) {
+		return snapshot_->properties().to_map();
+	}
 	return copy_udev_list(udev_device_get_properties_list_entry(raw_.get()));
 }
 
 std::map<std::string, std::string> DeviceImpl::tags() const
 {
+	if (snapshot_) {
+		return snapshot_->tags().to_map();
+	}
 	return copy_udev_list(udev_device_get_tags_list_entry(raw_.get()));
 }
 
 std::map<std::string, std::string> DeviceImpl::current_tags() const
 {
+	if (snapshot_) {
+		return snapshot_->current_tags().to_map();
+	}
 	return copy_udev_list(udev_device_get_current_tags_list_entry(raw_.get()));
 }
 
 std::map<std::string, std::string> DeviceImpl::sysattr() const
 {
+	if (snapshot_) {
+		return snapshot_->sysattr().to_map();
+	}
 	return copy_udev_list(udev_device_get_sysattr_list_entry(raw_.get()));
 }
 
 std::string DeviceImpl::property_value(std::string const& key) const
 {
+	if (snapshot_) {
+		return std::string{snapshot_->property_value(key)};
+	}
 	auto res = udev_device_get_property_value(raw_.get(), key.c_str());
 	return res ? res : "";
 }
@@ -228,7 +307,7 @@ std::string DeviceImpl::driver() const
 {
 	auto res = udev_device_get_driver(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_driver(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_driver(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -238,7 +317,7 @@ dev_t DeviceImpl::devnum() const
 {
 	auto res = udev_device_get_devnum(raw_.get());
 	if (::major(res) == 0 && ::minor(res) == 0) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_devnum(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_devnum(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -246,9 +325,9 @@ dev_t DeviceImpl::devnum() const
 
 std::string DeviceImpl::action() const
 {
-	auto res = udev_device_get_driver(raw_.get());
+	auto res = udev_device_get_action(raw_.get());
 	if (!res) {
-		throw std::runtime_error(Fmt::format("%s: udev_device_get_driver(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_device_get_action(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return res;
@@ -281,6 +360,9 @@ void DeviceImpl::sysattr_value(std::string const& sysattr, std::string const& va
 
 bool DeviceImpl::has_tag(std::string const& tag) const
 {
+	if (snapshot_) {
+		return snapshot_->has_tag(tag);
+	}
 	auto err = udev_device_has_tag(raw_.get(), tag.c_str());
 	if (err < 0) {
 		throw Posix::make_system_error(-err, "%s: udev_device_has_tag(%x, %s)",
@@ -291,6 +373,9 @@ bool DeviceImpl::has_tag(std::string const& tag) const
 
 bool DeviceImpl::has_current_tag(std::string const& tag) const
 {
+	if (snapshot_) {
+		return snapshot_->has_current_tag(tag);
+	}
 	auto err = udev_device_has_current_tag(raw_.get(), tag.c_str());
 	if (err < 0) {
 		throw Posix::make_system_error(-err, "%s: udev_device_has_current_tag(%x, %s)",
@@ -299,6 +384,14 @@ bool DeviceImpl::has_current_tag(std::string const& tag) const
 	return err > 0;
 }
 
+std::shared_ptr<DeviceSnapshot const> DeviceImpl::snapshot() const
+{
+	if (!snapshot_) {
+		snapshot_ = std::make_shared<DeviceSnapshot const>(make_snapshot(raw_.get()));
+	}
+	return snapshot_;
+}
+
 class MonitorImpl : public Monitor {
 public:
 	explicit MonitorImpl(unref_unique_ptr<udev_monitor>);
@@ -355,7 +448,7 @@ std::shared_ptr<Device> MonitorImpl::receive_device() const
 	auto dev = make_unref_unique_ptr(udev_monitor_receive_device(raw_.get()), &udev_device_unref);
 
 	if (!dev) {
-		throw std::runtime_error(Fmt::format("%s: udev_monitor_receive_device(%x)",
+		throw std::runtime_error(FMT_FORMAT("%s: udev_monitor_receive_device(%x)",
 					to_string(SourceLocation::current()), raw_.get()));
 	}
 	return std::make_shared<DeviceImpl>(std::move(dev));